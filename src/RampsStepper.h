@@ -1,11 +1,12 @@
 #pragma once
 #include <Arduino.h>
 #include <AccelStepper.h>
+#include "config.h"
 
 class RampsStepper
 {
 public:
-  RampsStepper(int stepPin, int dirPin, int enPin, bool inverseDir, float gearRatio, int stepsPerRev,
+  RampsStepper(int stepPin, int dirPin, int enPin, bool inverseDir, float stepsPerRad,
                bool enableActiveLow = true)
       : stepPin_(stepPin), dirPin_(dirPin), enPin_(enPin),
         enableActiveLow_(enableActiveLow),
@@ -16,10 +17,11 @@ public:
     // default disabled
     digitalWrite(enPin_, enableActiveLow_ ? HIGH : LOW);
 
-    stepsPerRad_ = (gearRatio * stepsPerRev) / (2.0f * PI);
+    stepsPerRad_ = stepsPerRad;
+    radPerStep_ = 1.0f / stepsPerRad;
     stepper_.setPinsInverted(inverseDir, false, false);
-    stepper_.setMaxSpeed(3000); // safe defaults
-    stepper_.setAcceleration(8000);
+    stepper_.setMaxSpeed(STEPPER_MAX_SPEED);
+    stepper_.setAcceleration(STEPPER_ACCEL);
   }
 
   // Enable/disable driver
@@ -34,24 +36,68 @@ public:
   int32_t getPosition() { return stepper_.currentPosition(); }
   void setPosition(int32_t s) { stepper_.setCurrentPosition(s); }
   bool isOnPosition() { return stepper_.distanceToGo() == 0; }
+  int32_t getTarget() { return stepper_.targetPosition(); }
+
+  // Top speed of the moves on the stepper's own ramp, as a share of
+  // STEPPER_MAX_SPEED. Constant-rate segments set their rate themselves.
+  void setSpeedScale(float scale) { stepper_.setMaxSpeed(STEPPER_MAX_SPEED * scale); }
+
+  // Decelerate to a standstill as fast as the acceleration limit allows
+  void stop()
+  {
+    constantRate_ = false;
+    stepper_.stop();
+  }
+
+  // Stop dead, no deceleration (a switch hit at homing speed)
+  void halt()
+  {
+    constantRate_ = false;
+    stepper_.setCurrentPosition(stepper_.currentPosition());
+  }
 
   // Commands in steps
-  void stepToPosition(int32_t s) { stepper_.moveTo(s); }
-  void stepRelative(int32_t ds) { stepper_.move(ds); }
+  void stepToPosition(int32_t s)
+  {
+    constantRate_ = false;
+    stepper_.moveTo(s);
+  }
+  void stepRelative(int32_t ds)
+  {
+    constantRate_ = false;
+    stepper_.move(ds);
+  }
+
+  // Pre-planned segment: run at a fixed rate (steps/s) without ramping
+  void stepToPositionAtRate(int32_t s, float stepsPerSec)
+  {
+    constantRate_ = true;
+    stepper_.moveTo(s); // recomputes speed, so set ours after
+    stepper_.setSpeed(s >= getPosition() ? stepsPerSec : -stepsPerSec);
+  }
 
   // Position (radians)
-  float getPositionRad() { return getPosition() / stepsPerRad_; }
+  float getPositionRad() { return getPosition() * radPerStep_; }
+  float getTargetRad() { return getTarget() * radPerStep_; }
   void setPositionRad(float rad) { setPosition(lroundf(rad * stepsPerRad_)); }
   void stepToPositionRad(float rad) { stepToPosition(lroundf(rad * stepsPerRad_)); }
   void stepRelativeRad(float rad) { stepRelative(lroundf(rad * stepsPerRad_)); }
 
   // Call frequently in loop()
-  void update() { stepper_.run(); }
+  void update()
+  {
+    if (constantRate_)
+      stepper_.runSpeedToPosition();
+    else
+      stepper_.run();
+  }
 
 private:
   int stepPin_, dirPin_, enPin_;
   bool enableActiveLow_;
+  bool constantRate_ = false;
   float stepsPerRad_ = 3200.0f / (2.0f * PI);
+  float radPerStep_ = (2.0f * PI) / 3200.0f;
 
   AccelStepper stepper_;
 };
@@ -0,0 +1,28 @@
+#pragma once
+
+/*
+ * Cycle-count markers for the simavr benchmark (env:simavrBench).
+ * A marker is one write of its id to GPIOR0, a spare I/O register that
+ * the simulator timestamps in CPU cycles. They compile to nothing unless
+ * BENCH_MARKERS is defined.
+ */
+
+#if defined(BENCH_MARKERS) && defined(ARDUINO_ARCH_AVR)
+#include <avr/io.h>
+#define BENCH_MARK(id) (GPIOR0 = (id))
+#else
+#define BENCH_MARK(id) ((void)0)
+#endif
+
+enum BenchMarker
+{
+  BENCH_LOOP_START = 1,
+  BENCH_STEPPERS_DONE, // stepper ticks
+  BENCH_IO_DONE,       // serial output, real-time requests, telemetry
+  BENCH_IDLE_DONE,     // parsing, queue, command execution
+  BENCH_MOTION_DONE,   // interpolation, IK, joint targets
+  BENCH_IK_START,
+  BENCH_IK_END,
+  BENCH_PARSE_START,
+  BENCH_PARSE_END
+};
@@ -1,7 +1,13 @@
 #include "config.h"
 #include "command.h"
+#include "bench.h"
 
-Command::Command()
+// Ends a line in rx whose bytes didn't all fit; the parser answers it with an
+// error. 0x18 is never stored otherwise, receiveByte() takes it as abort.
+#define RX_LINE_LOST 0x18
+
+Command::Command(Print *aout, Stream *ain, Stream *ain2)
+    : out(aout), in(ain), in2(ain2)
 {
   // initialize Command to a zero-move value;
   command.valueX = NAN;
@@ -9,121 +15,194 @@ Command::Command()
   command.valueZ = NAN;
   command.valueF = 0;
   command.valueT = 0;
+  command.valueS = NAN;
 
-  message = "";
+  messageLen = 0;
+  messageOverflow = false;
+  rxStart = 0;
+  rxCount = 0;
+  rxLost = false;
+  realtime = 0;
+  overrideSteps = 0;
 }
 
-bool Command::handleGcode()
+// Moves received bytes into the line buffer, catching real-time bytes on
+// the way. Cheap enough to call on every loop, moving or not. The UART is
+// always read empty, so real-time bytes get through even when the buffer is
+// full; G-code that doesn't fit is dropped, see receiveByte().
+void Command::receive()
 {
-  char c;
-  bool isDataAval = false;
-
-  if (Serial.available())
+  for (;;)
   {
-    c = Serial.read();
-    isDataAval = true;
+    if (in && in->available())
+    {
+      receiveByte(in->read());
+    }
+    else if (in2 && in2->available())
+    {
+      receiveByte(in2->read());
+    }
+    else
+    {
+      return;
+    }
   }
-  else if (Serial2.available())
+}
+
+void Command::receiveByte(char c)
+{
+  switch (c)
   {
-    c = Serial2.read();
-    isDataAval = true;
+  case '?':
+    realtime |= RT_STATUS_REPORT;
+    break;
+  case '!':
+    realtime |= RT_FEED_HOLD;
+    break;
+  case '~':
+    realtime |= RT_CYCLE_START;
+    break;
+  case 0x18:
+    realtime |= RT_ABORT;
+    break;
+  case (char)0x90:
+    realtime |= RT_OVR_RESET;
+    overrideSteps = 0; // steps before the reset no longer count
+    break;
+  case (char)0x91:
+    overrideStep(10);
+    break;
+  case (char)0x92:
+    overrideStep(-10);
+    break;
+  case (char)0x93:
+    overrideStep(1);
+    break;
+  case (char)0x94:
+    overrideStep(-1);
+    break;
+  default:
+    if (!rxLost && rxCount < RX_BUFFER_SIZE - 1)
+    {
+      rx[(rxStart + rxCount++) % RX_BUFFER_SIZE] = c;
+    }
+    else if (c == '\r' && rxCount < RX_BUFFER_SIZE)
+    {
+      // a line end takes the last slot, kept free for it; as RX_LINE_LOST
+      // if the line is missing bytes
+      rx[(rxStart + rxCount++) % RX_BUFFER_SIZE] = rxLost ? RX_LINE_LOST : '\r';
+      rxLost = false;
+    }
+    else if (c != '\n') // skipped by the parser anyway
+    {
+      // no room: like GRBL, drop the byte, and with it the rest of its line
+      // (and the next one too if its end doesn't find the last slot free)
+      rxLost = true;
+    }
   }
+}
 
-  if (isDataAval)
+// Assembles buffered input into a line; true once a valid command is parsed.
+bool Command::handleGcode()
+{
+  receive();
+  while (rxCount > 0)
   {
+    char c = rx[rxStart];
+    rxStart = (rxStart + 1) % RX_BUFFER_SIZE;
+    rxCount--;
+
     if (c == '\n')
     {
-      return false;
+      continue;
     }
-    if (c == '\r')
+    if (c == '\r' || c == RX_LINE_LOST)
     {
+      message[messageLen] = '\0';
+      messageLen = 0;
+      if (messageOverflow || c == RX_LINE_LOST)
+      {
+        // too long to be a valid command, or missing bytes, already cut short
+        messageOverflow = false;
+        if (out)
+          printErr(*out);
+        return false;
+      }
+      BENCH_MARK(BENCH_PARSE_START);
       bool b = processMessage(message);
-      message = "";
+      BENCH_MARK(BENCH_PARSE_END);
       return b;
     }
+    else if (messageLen < LINE_BUFFER_SIZE - 1)
+    {
+      message[messageLen++] = c;
+    }
     else
     {
-      message += c;
+      messageOverflow = true;
     }
   }
   return false;
 }
 
-bool Command::processMessage(String &msg)
+// Parses one line in place: "<G|M><num>" then up to 6 "<letter><value>"
+// words, each after a single space.
+bool Command::processMessage(const char *msg)
 {
-  msg += ' '; // helps parsing
   command.id = msg[0];
   // exit if not GCode
   if ((command.id != 'G') && (command.id != 'M'))
   {
-    printErr();
-    return false;
-  }
-  // parse number
-  int first = 1;
-  int last = pos(msg, ' ', 1);
-  if (last < 0)
-  {
-    printErr();
+    if (out)
+      printErr(*out);
     return false;
   }
-  String s = msg.substring(first, last);
-  command.num = s.toInt();
+  command.num = atoi(msg + 1);
 
-  // parse up to 5 Values
+  // parse up to 6 Values
   command.valueX = NAN;
   command.valueY = NAN;
   command.valueZ = NAN;
   command.valueF = 0;
   command.valueT = 0;
-  int parsePosition = last + 1;
-  int i = 0;
-  while (i < 5)
+  command.valueS = NAN;
+  const char *p = strchr(msg, ' ');
+  for (uint8_t i = 0; p != NULL && i < 6; i++)
   {
-    char id = msg[parsePosition++];
-    if (id != ' ')
-    { // test if a command here
-      int first = parsePosition;
-      int last = pos(msg, ' ', parsePosition);
-      if (last < first)
-      {        // test if String is valid
-        i = 5; // exit;
-      }
-      else
-      {
-        String floatString = msg.substring(first, last); // should contain a Numeric value
-        float value = floatString.toFloat();
-        switch (id)
-        {
-        case 'X':
-          command.valueX = value;
-          break;
-        case 'Y':
-          command.valueY = value;
-          break;
-        case 'Z':
-          command.valueZ = value;
-          break;
-        case 'E':
-          command.valueZ = value;
-          break;
-        case 'F':
-          command.valueF = value;
-          break;
-        case 'T':
-          command.valueT = value;
-          break;
-        default:
-          i = 5;
-        }
-        parsePosition = last + 1;
-      }
-    }
-    else
+    char id = *++p;
+    if (id == ' ' || id == '\0')
+      break;
+    float value = (p[1] == ' ') ? 0.0f : (float)atof(p + 1); // should contain a Numeric value
+    switch (id)
     {
-      i = 5; // exit;
+    case 'X':
+      command.valueX = value;
+      break;
+    case 'Y':
+      command.valueY = value;
+      break;
+    case 'Z':
+      command.valueZ = value;
+      break;
+    case 'E':
+      command.valueZ = value;
+      break;
+    case 'F':
+      command.valueF = value;
+      break;
+    case 'T':
+      command.valueT = value;
+      break;
+    case 'S':
+      command.valueS = value;
+      break;
+    case 'B':
+      command.valueS = value;
+      break;
+    default:
+      return true;
     }
-    i++;
+    p = strchr(p, ' ');
   }
 
   return true;
@@ -134,37 +213,83 @@ Cmd Command::getCmd() const
   return command;
 }
 
-int Command::pos(String &s, char c, int start)
+uint16_t Command::getRealtime() const
 {
-  int len = s.length();
-  for (int i = start; i < len; i++)
-  {
-    if (c == s[i])
-    {
-      return i;
-    }
-  }
-  return -1;
+  return realtime;
+}
+
+void Command::clearRealtime(uint16_t flags)
+{
+  realtime &= ~flags;
+}
+
+// Several override bytes in one receive() pass each count; the sum is
+// clamped to the override range, which is all one call can move anyway.
+void Command::overrideStep(int8_t percent)
+{
+  overrideSteps += percent;
+  if (overrideSteps > FEED_OVERRIDE_MAX)
+    overrideSteps = FEED_OVERRIDE_MAX;
+  if (overrideSteps < -FEED_OVERRIDE_MAX)
+    overrideSteps = -FEED_OVERRIDE_MAX;
+  realtime |= RT_OVR_STEP;
+}
+
+int16_t Command::takeOverrideSteps()
+{
+  int16_t steps = overrideSteps;
+  overrideSteps = 0;
+  realtime &= ~RT_OVR_STEP;
+  return steps;
+}
+
+// Room for G-code, which may use all but the slot kept for RX_LINE_LOST.
+int Command::getRxFree() const
+{
+  return (rxCount < RX_BUFFER_SIZE - 1) ? RX_BUFFER_SIZE - 1 - rxCount : 0;
+}
+
+bool Command::isRxEmpty() const
+{
+  return rxCount == 0;
+}
+
+// Drops buffered input and any half-received line, e.g. on abort. A line
+// already being dropped for lack of room is still dropped to its end.
+void Command::flush()
+{
+  rxStart = 0;
+  rxCount = 0;
+  messageLen = 0;
+  messageOverflow = false;
+}
+
+void printErr(Print &out)
+{
+  out.println("rs"); //'resend'
 }
 
-void printErr()
+void printFault(Print &out)
 {
-  SERIALX.println("rs"); //'resend'
+  out.println("!!");
 }
 
-void printFault()
+void printComment(Print &out, const char *c)
 {
-  SERIALX.println("!!");
+  out.print("// ");
+  out.println(c);
 }
 
-void printComment(char *c)
+void printComment(Print &out, const char *prefix, const char *text)
 {
-  SERIALX.print("// ");
-  SERIALX.println(c);
+  out.print("// ");
+  out.print(prefix);
+  out.println(text);
 }
 
-void printComment(String &s)
+void printComment(Print &out, const char *prefix, long value)
 {
-  SERIALX.print("// ");
-  SERIALX.println(s);
+  out.print("// ");
+  out.print(prefix);
+  out.println(value);
 }
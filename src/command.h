@@ -1,5 +1,6 @@
 #pragma once
 #include <Arduino.h>
+#include "config.h"
 
 struct Cmd
 {
@@ -10,23 +11,55 @@ struct Cmd
   float valueZ;
   float valueF;
   float valueT;
+  float valueS;
 };
 
+// real-time requests, picked out of the input stream as soon as they arrive
+#define RT_STATUS_REPORT 0x0001 // '?'
+#define RT_FEED_HOLD 0x0002     // '!'
+#define RT_CYCLE_START 0x0004   // '~'
+#define RT_ABORT 0x0008         // 0x18 (ctrl-x)
+#define RT_OVR_RESET 0x0010     // 0x90 feed override 100%
+#define RT_OVR_STEP 0x0020      // 0x91..0x94 +10/-10/+1/-1 percent, summed in takeOverrideSteps()
+
 class Command
 {
 public:
-  Command();
+  // Input is read from in (and in2, if given), parse errors are answered on out.
+  Command(Print *out = NULL, Stream *in = NULL, Stream *in2 = NULL);
+  void receive();
   bool handleGcode();
-  bool processMessage(String &msg);
+  bool processMessage(const char *msg);
   Cmd getCmd() const;
 
+  uint16_t getRealtime() const;
+  void clearRealtime(uint16_t flags);
+  int16_t takeOverrideSteps(); // percent since the last call, after any reset
+  int getRxFree() const;
+  bool isRxEmpty() const;
+  void flush();
+
 private:
-  int pos(String &s, char c, int start = 0);
-  String message;
+  void receiveByte(char c);
+  void overrideStep(int8_t percent);
+  char message[LINE_BUFFER_SIZE]; // line being assembled
+  uint8_t messageLen;
+  bool messageOverflow; // line too long, dropped at its end
   Cmd command;
+  Print *out;
+  Stream *in;
+  Stream *in2;
+
+  char rx[RX_BUFFER_SIZE];
+  uint8_t rxStart;
+  uint8_t rxCount;
+  bool rxLost; // dropping the rest of a line that didn't fit
+  uint16_t realtime;
+  int16_t overrideSteps;
 };
 
-void printErr();
-void printFault();
-void printComment(char *c);
-void printComment(String &s);
+void printErr(Print &out);
+void printFault(Print &out);
+void printComment(Print &out, const char *c);
+void printComment(Print &out, const char *prefix, const char *text);
+void printComment(Print &out, const char *prefix, long value);
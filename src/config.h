@@ -3,7 +3,13 @@
 
 // SERIAL SETTINGS
 #define SERIALX Serial
-#define BAUD 9600
+#define BAUD 9600 // START-UP BAUD, CHANGE AT RUNTIME WITH M575 B<baud>
+#define MAX_BAUD 1000000
+#define TX_BUFFER_SIZE 256 // BYTES OF OUTPUT BUFFERED AHEAD OF THE UART
+#define RX_BUFFER_SIZE 128 // BYTES OF INPUT BUFFERED AHEAD OF THE PARSER, MAX 255
+#define LINE_BUFFER_SIZE 64 // LONGEST G-CODE LINE + 1, LONGER ONES ARE DROPPED WITH "rs", MAX 255
+#define STATUS_REPORT_MAX 104 // LONGEST '?' STATUS LINE, IN BYTES
+#define TELEMETRY_MAX_HZ 200 // UPPER LIMIT FOR M154 S<Hz>, 37 BYTES PER FRAME
 
 // ROBOT ARM LENGTH
 #define LOW_SHANK_LENGTH 180.0
@@ -11,40 +17,99 @@
 
 #define END_EFFECTOR_OFFSET 0.0 // LENGTH FROM UPPER SHANK BEARING TO MIDPOINT OF END EFFECTOR IN MM. Not 54
 
+// KINEMATICS BACKEND
+#define KINEMATICS_SCARA
+// #define KINEMATICS_LUT // SCARA WITH THE INVERSE FROM FLASH TABLES, RERUN tools/lutGen AFTER CHANGING L1, L2 OR R_MIN
+
 // SCARA SETTINGS
 #define L1 153.0 // shank1 length
 #define L2 161.0 // shank2 length + gripperoffset
 #define LEAD 8.0
+#define HIGH_COUPLING (33.0 / 62.0) // HIGH JOINT TURNS WITH THE LOW JOINT BY THIS RATIO
 #define GRIPPERFLOATHEIGHT 0.0 // mm, was 20.0
 
 // INITIAL INTERPOLATION SETTINGS
 #define INITIAL_X (L1 + L2) // CARTESIAN COORDINATE X
 #define INITIAL_Y 0.0       // CARTESIAN COORDINATE Y
 #define INITIAL_Z Z_MAX     // CARTESIAN COORDINATE Z
+#define MOVE_EPS_MM 0.001   // AXIS CHANGES BELOW THIS COUNT AS NO CHANGE WHEN CLASSIFYING A MOVE
 
 // STEPPER SETTINGS:
 #define INVERSE_X_STEPPER true // true IF STEPPER MOVES OTHER WAY.
 #define INVERSE_Y_STEPPER true // true IF STEPPER MOVES OTHER WAY.
 #define INVERSE_Z_STEPPER true // true IF STEPPER MOVES OTHER WAY
+#define STEPPER_MAX_SPEED 3000 // STEPS/S, PER JOINT
+#define STEPPER_ACCEL 8000     // STEPS/S^2, PER JOINT
+
+// HOMING SETTINGS (G28)
+#define HOME_SEEK_SPEED 1500       // STEPS/S, FAST APPROACH TO THE SWITCH
+#define HOME_LATCH_SPEED 200       // STEPS/S, SLOW RE-APPROACH THAT SETS HOME
+#define HOME_BACKOFF_STEPS 100     // STEPS OFF THE SWITCH BETWEEN THE TWO
+#define HOME_HIGHER_SEEK_MAX_STEPS (1.1 * HIGHER_GEAR_RATIO * STEPS_PER_REV) // NO SWITCH WITHIN THIS MANY STEPS IS A FAULT:
+#define HOME_LOWER_SEEK_MAX_STEPS (1.1 * LOWER_GEAR_RATIO * STEPS_PER_REV)   // A LITTLE OVER ONE JOINT REVOLUTION,
+#define HOME_ROTATE_SEEK_MAX_STEPS 150000                                  // FULL Z TRAVEL FOR THE ROTATE JOINT
+#define HOME_CONCURRENT false      // true: ALL JOINTS AT ONCE, false: Z FIRST, THEN LOWER, THEN HIGHER
+#define ENDSTOP_HIT HIGH           // PIN LEVEL OF A PRESSED SWITCH (NC SWITCHES, PULL-UPS ON)
+#define HOME_HIGHER_DIR -1         // SEEK DIRECTION PER JOINT, IN STEPS
+#define HOME_LOWER_DIR -1
+#define HOME_ROTATE_DIR -1
+#define HOME_HIGHER_DEG -220.0     // JOINT ANGLE AT THE SWITCH, AS INVERSE KINEMATICS REPORTS IT,
+#define HOME_LOWER_DEG -185.0      // JUST PAST THE MOVE LIMITS IN THE SEEK DIRECTION
+#define HOME_Z_MM (Z_MAX + 2.0)    // Z AT THE ROTATE JOINT'S SWITCH
 
 // GEAR RATIO SETTINGS
 #define MOTOR_GEAR_TEETH 9.0 // 20.0 FOR 20SFFACTORY BELT VERSION   9.0 FOR FTOBLER GEAR VERSION
 #define MAIN_GEAR_TEETH 32.0 // 90.0 FOR 20SFFACTORY BELT VERSION   32.0 FOR FTOBLER GEAR VERSION
+#define HIGHER_GEAR_RATIO ((62.0 / 16.0) * (62.0 / 33.0))
+#define LOWER_GEAR_RATIO (72.0 / 16.0)
+#define ROTATE_GEAR_RATIO 1.0
+#define STEPS_PER_REV (200 * 16) // FULL STEPS * MICROSTEPS
 
 // SERVO GRIPPER SETTINGS
 #define SERVO_GRIP_DEGREE 0.0
 #define SERVO_UNGRIP_DEGREE 45.0
+#define SERVO_MOVE_MS 300 // TIME THE SERVO GETS TO REACH ITS ANGLE
+
+// MOTION-SYNCED OUTPUT SETTINGS
+#define SYNC_EVENT_MAX 4 // OUTPUT EVENTS THAT CAN WAIT FOR ONE MOVE
 
 // COMMAND QUEUE SETTINGS
 #define QUEUE_SIZE 15
 
+// PROGRAM STORAGE SETTINGS (EEPROM, 4096 BYTES ON THE MEGA)
+#define PROGRAM_START 0           // FIRST EEPROM BYTE OF THE RECORDED PROGRAM
+#define PROGRAM_SIZE 3072         // BYTES RESERVED FOR THE RECORDED PROGRAM
+#define TEACH_START (PROGRAM_START + PROGRAM_SIZE) // TAUGHT STATIONS (M700/M701) FOLLOW THE PROGRAM
+#define TEACH_POINTS 40           // STATIONS, 25 BYTES EACH
+#define STORAGE_SIZE 4096         // NATIVE BUILD ONLY: SIZE OF THE EMULATED EEPROM
+#define STORAGE_FILE "eeprom.bin" // NATIVE BUILD ONLY: FILE BACKING THE EMULATED EEPROM
+#define STORAGE_ENV "ROBOT_EEPROM" // NATIVE BUILD ONLY: ENVIRONMENT VARIABLE WITH ANOTHER PATH FOR IT
+
+// FEED OVERRIDE / HOLD SETTINGS
+#define FEED_RAMP_S 0.25        // SECONDS FOR A FULL 100% FEED CHANGE, E.G. HOLD FROM FULL SPEED
+#define FEED_OVERRIDE_MIN 10    // PERCENT
+#define FEED_OVERRIDE_MAX 200   // PERCENT
+
+// CPU BUDGET SETTINGS
+#define CPU_WINDOW_US 20000   // JOINT STEP RATES ARE MEASURED OVER THIS LONG DURING MOVES
+#define CPU_STEP_HEADROOM 0.9 // SHARE OF THE STEP RATE THE LOOP CAN DELIVER THAT MOVES MAY USE
+#define CPU_FEED_CAP_MIN 0.05 // LOWEST FEED SCALE THE THROTTLE GOES DOWN TO
+
+// RAM SETTINGS
+#define STACK_PAINT 0xC5 // FILLS FREE RAM AT START-UP, M122 COUNTS WHAT IS LEFT OF IT
+
 // LOG SETTINGS
 #define LOG_LEVEL 2
 // 0: ERROR
 // 1: INFO
 // 2: DEBUG
 
-// MOVE LIMIT PARAMETERS
+// MOVE LIMIT PARAMETERS, CHECKED WHEN A MOVE IS QUEUED
 #define Z_MIN -140.0                    // MINIMUM Z HEIGHT OF TOOLHEAD TOUCHING GROUND
 #define Z_MAX (LOW_SHANK_LENGTH + 30.0) // SHANK_LENGTH ADDING ARBITUARY NUMBER FOR Z_MAX
+#define R_MIN 50.0                      // mm, KEEP-OUT RADIUS AROUND THE BASE, OUTER LIMIT IS L1 + L2
+#define LOW_MIN_DEG -180.0              // JOINT STOPS AS INVERSE KINEMATICS REPORTS THE ANGLES,
+#define LOW_MAX_DEG 180.0               // THE DEFAULTS LET THE WHOLE ANNULUS THROUGH
+#define HIGH_MIN_DEG -215.0
+#define HIGH_MAX_DEG 215.0
 #endif
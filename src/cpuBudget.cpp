@@ -0,0 +1,155 @@
+#include <Arduino.h>
+#include "cpuBudget.h"
+#include "config.h"
+
+CpuBudget::CpuBudget()
+    : lastTickUs(0), loopAvgUs(0), loopMaxUs(0), lastMoveUs(0), movePeriodUs(0),
+      windowUs(0), demand(0), cap(1.0f)
+{
+  clearCounters();
+  for (uint8_t j = 0; j < 3; j++)
+  {
+    last[j] = 0;
+    moved[j] = 0;
+  }
+}
+
+// The one place the loop period is measured
+uint16_t CpuBudget::tick(uint32_t nowUs)
+{
+  uint32_t period = nowUs - lastTickUs;
+  lastTickUs = nowUs;
+  if (period > 0xFFFF)
+    period = 0xFFFF;
+  if (period > loopMaxUs)
+    loopMaxUs = period;
+  // dwells and blocking gripper moves stall on purpose, they aren't load
+  if (period < CPU_WINDOW_US)
+    loopAvgUs += (period - loopAvgUs) * 0.125f;
+  return period;
+}
+
+void CpuBudget::startMove(uint32_t nowUs, int32_t higher, int32_t lower, int32_t rotate)
+{
+  lastMoveUs = nowUs;
+  last[0] = higher;
+  last[1] = lower;
+  last[2] = rotate;
+  moved[0] = moved[1] = moved[2] = 0;
+  windowUs = 0;
+  demand = 0;
+}
+
+bool CpuBudget::track(uint32_t nowUs, int32_t higher, int32_t lower, int32_t rotate)
+{
+  uint32_t dt = nowUs - lastMoveUs;
+  lastMoveUs = nowUs;
+  movePeriodUs += ((float)dt - movePeriodUs) * 0.125f;
+
+  // a pass long enough for the busiest joint to owe more than one step
+  if (demand * dt > 1e6f)
+    deadlineMisses++;
+
+  const int32_t now[3] = {higher, lower, rotate};
+  for (uint8_t j = 0; j < 3; j++)
+  {
+    moved[j] += labs(now[j] - last[j]);
+    last[j] = now[j];
+  }
+  windowUs += dt;
+  if (windowUs < CPU_WINDOW_US)
+    return false;
+
+  uint32_t most = moved[0];
+  if (moved[1] > most)
+    most = moved[1];
+  if (moved[2] > most)
+    most = moved[2];
+  demand = most * 1e6f / windowUs;
+  if (cap < 1.0f)
+    throttleUs += windowUs;
+  moved[0] = moved[1] = moved[2] = 0;
+  windowUs = 0;
+
+  float limit = getStepLimit();
+  float old = cap;
+  if (demand > limit)
+  {
+    if (cap >= 1.0f)
+      throttleCount++;
+    cap *= limit / demand;
+    if (cap < CPU_FEED_CAP_MIN)
+      cap = CPU_FEED_CAP_MIN;
+  }
+  else if (cap < 1.0f && demand < limit * 0.8f)
+  {
+    cap *= 1.1f; // ease back up, the hysteresis keeps it from hunting
+    if (cap > 1.0f)
+      cap = 1.0f;
+  }
+  return cap != old;
+}
+
+float CpuBudget::getFeedCap() const
+{
+  return cap;
+}
+
+float CpuBudget::getStepLimit() const
+{
+  // passes while moving carry the IK, G6 segments only show in the average
+  float period = (movePeriodUs > loopAvgUs) ? movePeriodUs : loopAvgUs;
+  if (period < 1.0f)
+    period = 1.0f;
+  float passes = ceilf((1e6f / STEPPER_MAX_SPEED) / period);
+  return CPU_STEP_HEADROOM * 1e6f / (passes * period);
+}
+
+// A G6 segment asking for more than the loop can step is run slower.
+float CpuBudget::limitSegment(float seconds, int32_t steps)
+{
+  float shortest = labs(steps) / getStepLimit();
+  if (seconds >= shortest)
+    return seconds;
+  stretchedSegments++;
+  return shortest;
+}
+
+uint16_t CpuBudget::getLoopAvgUs() const
+{
+  return (uint16_t)loopAvgUs;
+}
+
+uint16_t CpuBudget::getLoopMaxUs() const
+{
+  return loopMaxUs;
+}
+
+uint32_t CpuBudget::getThrottleCount() const
+{
+  return throttleCount;
+}
+
+uint32_t CpuBudget::getThrottleMs() const
+{
+  return throttleUs / 1000;
+}
+
+uint32_t CpuBudget::getDeadlineMisses() const
+{
+  return deadlineMisses;
+}
+
+uint32_t CpuBudget::getStretchedSegments() const
+{
+  return stretchedSegments;
+}
+
+void CpuBudget::clearCounters()
+{
+  loopMaxUs = 0;
+  throttleCount = 0;
+  throttleUs = 0;
+  deadlineMisses = 0;
+  stretchedSegments = 0;
+}
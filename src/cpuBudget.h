@@ -0,0 +1,47 @@
+#pragma once
+#include <stdint.h>
+
+// Keeps requested step rates inside what loop() can deliver. A joint
+// steps at most once per pass, and AccelStepper rounds its step interval
+// up to whole passes, so the loop period sets a top step rate below
+// STEPPER_MAX_SPEED. During moves the joints' step rates are measured
+// over CPU_WINDOW_US; when one asks for more than the loop can deliver,
+// the feed is capped until it fits, then allowed back up.
+class CpuBudget
+{
+public:
+  CpuBudget();
+  uint16_t tick(uint32_t nowUs); // every loop pass; the pass's period, for telemetry too
+
+  void startMove(uint32_t nowUs, int32_t higher, int32_t lower, int32_t rotate);
+  bool track(uint32_t nowUs, int32_t higher, int32_t lower, int32_t rotate); // true: cap changed
+  float getFeedCap() const; // 0..1, multiplies the feed override
+
+  float getStepLimit() const; // steps/s the loop can deliver right now
+  float limitSegment(float seconds, int32_t steps); // stretched duration
+
+  uint16_t getLoopAvgUs() const;
+  uint16_t getLoopMaxUs() const;
+  uint32_t getThrottleCount() const;
+  uint32_t getThrottleMs() const;
+  uint32_t getDeadlineMisses() const;
+  uint32_t getStretchedSegments() const;
+  void clearCounters();
+
+private:
+  uint32_t lastTickUs;
+  float loopAvgUs;  // all passes short of CPU_WINDOW_US, moving or not
+  uint16_t loopMaxUs;
+  uint32_t lastMoveUs;
+  float movePeriodUs; // passes during moves, with IK
+  int32_t last[3];    // joint targets at the previous pass
+  uint32_t moved[3];  // steps per joint in this window
+  uint32_t windowUs;
+  float demand; // steps/s of the busiest joint in the last window
+  float cap;
+
+  uint32_t throttleCount;
+  uint32_t throttleUs;
+  uint32_t deadlineMisses;
+  uint32_t stretchedSegments;
+};
@@ -0,0 +1,178 @@
+#include <Arduino.h>
+#include "homing.h"
+#include "config.h"
+#include "pinout.h"
+#include "kinematics.h"
+
+Homing::Homing(RampsStepper &higher, RampsStepper &lower, RampsStepper &rotate)
+    : active(false), failed(false)
+{
+  // homing order when one at a time: Z up first, for clearance
+  HomeJoint order[3] = {
+      {&rotate, ROTATE_ENDSTOP_PIN, HOME_ROTATE_DIR, Kinematics::zToRot(HOME_Z_MM),
+       (int32_t)HOME_ROTATE_SEEK_MAX_STEPS, -1, HOME_DONE},
+      {&lower, LOWER_ENDSTOP_PIN, HOME_LOWER_DIR, (float)(HOME_LOWER_DEG * PI / 180.0),
+       (int32_t)HOME_LOWER_SEEK_MAX_STEPS, -1, HOME_DONE},
+      {&higher, HIGHER_ENDSTOP_PIN, HOME_HIGHER_DIR, (float)(HOME_HIGHER_DEG * PI / 180.0),
+       (int32_t)HOME_HIGHER_SEEK_MAX_STEPS, 1, HOME_DONE}};
+  for (uint8_t i = 0; i < 3; i++)
+  {
+    joints[i] = order[i];
+  }
+}
+
+void Homing::setup()
+{
+  for (uint8_t i = 0; i < 3; i++)
+  {
+    pinMode(joints[i].pin, INPUT_PULLUP);
+  }
+}
+
+void Homing::start()
+{
+  active = true;
+  failed = false;
+  for (uint8_t i = 0; i < 3; i++)
+  {
+    joints[i].phase = HOME_WAIT;
+    if (HOME_CONCURRENT || i == 0)
+      seek(joints[i]);
+  }
+}
+
+bool Homing::update()
+{
+  if (!active)
+    return false;
+
+  bool running = false;
+  for (uint8_t i = 0; i < 3; i++)
+  {
+    HomeJoint &j = joints[i];
+    step(j);
+    if (j.phase == HOME_FAILED)
+    {
+      abort();
+      failed = true;
+      return false;
+    }
+    if (j.phase == HOME_DONE)
+      continue;
+    if (j.phase == HOME_WAIT && ready(j))
+      seek(j);
+    running = true;
+    if (!HOME_CONCURRENT)
+      break;
+  }
+  active = running;
+  return running;
+}
+
+// Stops every joint where it is, the positions are not trusted after this
+void Homing::abort()
+{
+  if (!active)
+    return;
+  for (uint8_t i = 0; i < 3; i++)
+  {
+    if (joints[i].phase != HOME_DONE)
+    {
+      joints[i].stepper->halt();
+      joints[i].phase = HOME_FAILED;
+    }
+  }
+  active = false;
+}
+
+bool Homing::isActive() const
+{
+  return active;
+}
+
+bool Homing::hasFailed() const
+{
+  return failed;
+}
+
+bool Homing::hit(const HomeJoint &j) const
+{
+  return digitalRead(j.pin) == ENDSTOP_HIT;
+}
+
+bool Homing::ready(const HomeJoint &j) const
+{
+  return j.after < 0 || joints[j.after].phase == HOME_DONE;
+}
+
+void Homing::seek(HomeJoint &j)
+{
+  RampsStepper &s = *j.stepper;
+  if (hit(j))
+  {
+    // already on the switch: get off it first, or wait for the joint
+    // that moves the switch to have latched
+    if (!ready(j))
+    {
+      j.phase = HOME_WAIT;
+      return;
+    }
+    j.phase = HOME_BACKOFF;
+    s.stepToPositionAtRate(s.getPosition() - j.dir * HOME_BACKOFF_STEPS, HOME_SEEK_SPEED);
+    return;
+  }
+  j.phase = HOME_SEEK;
+  s.stepToPositionAtRate(s.getPosition() + j.dir * j.maxSteps, HOME_SEEK_SPEED);
+}
+
+// One pass of a joint's state machine. Running out of travel without the
+// switch tripping, or the switch staying pressed after the back-off, fails.
+void Homing::step(HomeJoint &j)
+{
+  RampsStepper &s = *j.stepper;
+  switch (j.phase)
+  {
+  case HOME_SEEK:
+    if (hit(j))
+    {
+      s.halt();
+      j.phase = HOME_BACKOFF;
+      s.stepToPositionAtRate(s.getPosition() - j.dir * HOME_BACKOFF_STEPS, HOME_SEEK_SPEED);
+    }
+    else if (s.isOnPosition())
+    {
+      j.phase = HOME_FAILED;
+    }
+    break;
+  case HOME_BACKOFF:
+    if (!s.isOnPosition())
+      break;
+    if (!ready(j))
+    {
+      j.phase = HOME_WAIT; // seeks again once it may latch
+      break;
+    }
+    if (hit(j))
+    {
+      j.phase = HOME_FAILED;
+      break;
+    }
+    j.phase = HOME_LATCH;
+    s.stepToPositionAtRate(s.getPosition() + j.dir * 2 * HOME_BACKOFF_STEPS, HOME_LATCH_SPEED);
+    break;
+  case HOME_LATCH:
+    if (hit(j))
+    {
+      s.halt();
+      s.setPositionRad(j.switchRad);
+      j.phase = HOME_DONE;
+    }
+    else if (s.isOnPosition())
+    {
+      j.phase = HOME_FAILED;
+    }
+    break;
+  default:
+    break;
+  }
+}
@@ -0,0 +1,55 @@
+#pragma once
+#include <stdint.h>
+#include "RampsStepper.h"
+
+enum HomePhase
+{
+  HOME_WAIT,    // sequential mode: an earlier joint is still homing
+  HOME_SEEK,    // fast, toward the switch
+  HOME_BACKOFF, // off the switch again
+  HOME_LATCH,   // slow, toward the switch; where it trips is home
+  HOME_DONE,
+  HOME_FAILED
+};
+
+struct HomeJoint
+{
+  RampsStepper *stepper;
+  uint8_t pin;
+  int8_t dir;       // seek direction in steps
+  float switchRad;  // joint angle where the switch trips
+  int32_t maxSteps; // seek this far without the switch is a fault
+  int8_t after;     // joint that has to latch before this one does, -1 none
+  uint8_t phase;
+};
+
+// G28: every joint seeks its endstop at HOME_SEEK_SPEED, backs off and
+// re-approaches at HOME_LATCH_SPEED, so the latch point doesn't depend on
+// how far the fast seek overshot. With HOME_CONCURRENT off the rotate
+// joint (Z) goes first, then lower, then higher. The higher joint's switch
+// rides on the upper arm, so the angle it trips at (HOME_HIGHER_DEG, with
+// the lower joint on its switch) moves with the lower joint; run together,
+// the higher joint seeks along but only latches once the lower one has.
+// Runs from loop() through update(), so the steppers and the serial link
+// keep being served.
+class Homing
+{
+public:
+  Homing(RampsStepper &higher, RampsStepper &lower, RampsStepper &rotate);
+  void setup();
+  void start();
+  bool update(); // true while homing runs
+  void abort();
+  bool isActive() const;
+  bool hasFailed() const;
+
+private:
+  bool hit(const HomeJoint &j) const;
+  bool ready(const HomeJoint &j) const;
+  void seek(HomeJoint &j);
+  void step(HomeJoint &j);
+
+  HomeJoint joints[3];
+  bool active;
+  bool failed;
+};
@@ -0,0 +1,211 @@
+// Generated by tools/lutGen: do not edit.
+#include "config.h"
+
+#if defined(KINEMATICS_LUT)
+#include "ikLut.h"
+
+const uint16_t ikLutShoulder[1127] PROGMEM = {
+  65535, 65307, 65087, 64873, 64666, 64464, 64268, 64077, 63891, 63710, 63533, 63360,
+  63191, 63025, 62863, 62705, 62549, 62397, 62247, 62100, 61956, 61814, 61674, 61537,
+  61402, 61269, 61138, 61009, 60882, 60757, 60633, 60512, 60391, 60273, 60155, 60040,
+  59925, 59812, 59701, 59591, 59481, 59374, 59267, 59161, 59057, 58953, 58851, 58750,
+  58649, 58550, 58451, 58354, 58257, 58161, 58066, 57972, 57879, 57787, 57695, 57604,
+  57513, 57424, 57335, 57247, 57159, 57072, 56986, 56901, 56816, 56731, 56647, 56564,
+  56482, 56399, 56318, 56237, 56156, 56076, 55997, 55918, 55839, 55761, 55684, 55607,
+  55530, 55454, 55378, 55302, 55228, 55153, 55079, 55005, 54932, 54859, 54786, 54714,
+  54642, 54571, 54500, 54429, 54359, 54288, 54219, 54149, 54080, 54011, 53943, 53875,
+  53807, 53739, 53672, 53605, 53539, 53472, 53406, 53340, 53275, 53210, 53145, 53080,
+  53015, 52951, 52887, 52823, 52760, 52697, 52634, 52571, 52508, 52446, 52384, 52322,
+  52261, 52199, 52138, 52077, 52016, 51956, 51896, 51835, 51775, 51716, 51656, 51597,
+  51538, 51479, 51420, 51361, 51303, 51245, 51187, 51129, 51071, 51014, 50956, 50899,
+  50842, 50785, 50729, 50672, 50616, 50560, 50504, 50448, 50392, 50337, 50281, 50226,
+  50171, 50116, 50061, 50007, 49952, 49898, 49843, 49789, 49735, 49682, 49628, 49574,
+  49521, 49468, 49414, 49361, 49309, 49256, 49203, 49151, 49098, 49046, 48994, 48942,
+  48890, 48838, 48786, 48735, 48683, 48632, 48581, 48530, 48479, 48428, 48377, 48326,
+  48276, 48225, 48175, 48125, 48074, 48024, 47974, 47925, 47875, 47825, 47776, 47726,
+  47677, 47628, 47578, 47529, 47480, 47431, 47383, 47334, 47285, 47237, 47188, 47140,
+  47092, 47044, 46995, 46947, 46900, 46852, 46804, 46756, 46709, 46661, 46614, 46566,
+  46519, 46472, 46425, 46378, 46331, 46284, 46237, 46190, 46144, 46097, 46051, 46004,
+  45958, 45912, 45865, 45819, 45773, 45727, 45681, 45635, 45589, 45544, 45498, 45452,
+  45407, 45361, 45316, 45271, 45225, 45180, 45135, 45090, 45045, 45000, 44955, 44910,
+  44865, 44821, 44776, 44732, 44687, 44643, 44598, 44554, 44509, 44465, 44421, 44377,
+  44333, 44289, 44245, 44201, 44157, 44113, 44069, 44026, 43982, 43938, 43895, 43851,
+  43808, 43765, 43721, 43678, 43635, 43592, 43548, 43505, 43462, 43419, 43376, 43333,
+  43291, 43248, 43205, 43162, 43120, 43077, 43034, 42992, 42949, 42907, 42865, 42822,
+  42780, 42738, 42695, 42653, 42611, 42569, 42527, 42485, 42443, 42401, 42359, 42317,
+  42275, 42234, 42192, 42150, 42109, 42067, 42025, 41984, 41942, 41901, 41859, 41818,
+  41777, 41735, 41694, 41653, 41612, 41570, 41529, 41488, 41447, 41406, 41365, 41324,
+  41283, 41242, 41201, 41160, 41120, 41079, 41038, 40997, 40957, 40916, 40876, 40835,
+  40794, 40754, 40713, 40673, 40633, 40592, 40552, 40511, 40471, 40431, 40391, 40350,
+  40310, 40270, 40230, 40190, 40150, 40110, 40070, 40030, 39990, 39950, 39910, 39870,
+  39830, 39790, 39750, 39711, 39671, 39631, 39591, 39552, 39512, 39472, 39433, 39393,
+  39354, 39314, 39275, 39235, 39196, 39156, 39117, 39077, 39038, 38999, 38959, 38920,
+  38881, 38841, 38802, 38763, 38724, 38685, 38645, 38606, 38567, 38528, 38489, 38450,
+  38411, 38372, 38333, 38294, 38255, 38216, 38177, 38138, 38099, 38060, 38021, 37983,
+  37944, 37905, 37866, 37827, 37789, 37750, 37711, 37673, 37634, 37595, 37557, 37518,
+  37479, 37441, 37402, 37364, 37325, 37287, 37248, 37210, 37171, 37133, 37094, 37056,
+  37017, 36979, 36940, 36902, 36864, 36825, 36787, 36749, 36710, 36672, 36634, 36595,
+  36557, 36519, 36481, 36442, 36404, 36366, 36328, 36289, 36251, 36213, 36175, 36137,
+  36099, 36061, 36022, 35984, 35946, 35908, 35870, 35832, 35794, 35756, 35718, 35680,
+  35642, 35604, 35566, 35528, 35490, 35452, 35414, 35376, 35338, 35300, 35262, 35224,
+  35186, 35149, 35111, 35073, 35035, 34997, 34959, 34921, 34883, 34846, 34808, 34770,
+  34732, 34694, 34656, 34619, 34581, 34543, 34505, 34468, 34430, 34392, 34354, 34316,
+  34279, 34241, 34203, 34165, 34128, 34090, 34052, 34014, 33977, 33939, 33901, 33864,
+  33826, 33788, 33750, 33713, 33675, 33637, 33600, 33562, 33524, 33487, 33449, 33411,
+  33374, 33336, 33298, 33260, 33223, 33185, 33147, 33110, 33072, 33034, 32997, 32959,
+  32921, 32884, 32846, 32808, 32771, 32733, 32695, 32658, 32620, 32582, 32545, 32507,
+  32469, 32432, 32394, 32356, 32319, 32281, 32243, 32206, 32168, 32130, 32093, 32055,
+  32017, 31979, 31942, 31904, 31866, 31829, 31791, 31753, 31715, 31678, 31640, 31602,
+  31565, 31527, 31489, 31451, 31414, 31376, 31338, 31300, 31262, 31225, 31187, 31149,
+  31111, 31074, 31036, 30998, 30960, 30922, 30884, 30847, 30809, 30771, 30733, 30695,
+  30657, 30619, 30582, 30544, 30506, 30468, 30430, 30392, 30354, 30316, 30278, 30240,
+  30202, 30164, 30126, 30088, 30050, 30012, 29974, 29936, 29898, 29860, 29822, 29784,
+  29746, 29708, 29670, 29632, 29594, 29555, 29517, 29479, 29441, 29403, 29365, 29326,
+  29288, 29250, 29212, 29173, 29135, 29097, 29059, 29020, 28982, 28944, 28905, 28867,
+  28829, 28790, 28752, 28713, 28675, 28637, 28598, 28560, 28521, 28483, 28444, 28406,
+  28367, 28329, 28290, 28251, 28213, 28174, 28136, 28097, 28058, 28020, 27981, 27942,
+  27904, 27865, 27826, 27787, 27748, 27710, 27671, 27632, 27593, 27554, 27515, 27476,
+  27437, 27398, 27359, 27320, 27281, 27242, 27203, 27164, 27125, 27086, 27047, 27008,
+  26968, 26929, 26890, 26851, 26811, 26772, 26733, 26694, 26654, 26615, 26575, 26536,
+  26496, 26457, 26417, 26378, 26338, 26299, 26259, 26220, 26180, 26140, 26101, 26061,
+  26021, 25981, 25942, 25902, 25862, 25822, 25782, 25742, 25702, 25662, 25622, 25582,
+  25542, 25502, 25462, 25422, 25382, 25341, 25301, 25261, 25221, 25180, 25140, 25100,
+  25059, 25019, 24978, 24938, 24897, 24857, 24816, 24775, 24735, 24694, 24653, 24613,
+  24572, 24531, 24490, 24449, 24408, 24367, 24326, 24285, 24244, 24203, 24162, 24121,
+  24080, 24038, 23997, 23956, 23914, 23873, 23832, 23790, 23749, 23707, 23665, 23624,
+  23582, 23540, 23499, 23457, 23415, 23373, 23331, 23289, 23247, 23205, 23163, 23121,
+  23079, 23037, 22995, 22952, 22910, 22868, 22825, 22783, 22740, 22698, 22655, 22613,
+  22570, 22527, 22484, 22442, 22399, 22356, 22313, 22270, 22227, 22184, 22140, 22097,
+  22054, 22011, 21967, 21924, 21880, 21837, 21793, 21750, 21706, 21662, 21619, 21575,
+  21531, 21487, 21443, 21399, 21355, 21310, 21266, 21222, 21178, 21133, 21089, 21044,
+  21000, 20955, 20910, 20865, 20821, 20776, 20731, 20686, 20641, 20595, 20550, 20505,
+  20460, 20414, 20369, 20323, 20278, 20232, 20186, 20140, 20094, 20048, 20002, 19956,
+  19910, 19864, 19818, 19771, 19725, 19678, 19632, 19585, 19538, 19491, 19444, 19397,
+  19350, 19303, 19256, 19209, 19161, 19114, 19066, 19018, 18971, 18923, 18875, 18827,
+  18779, 18731, 18682, 18634, 18586, 18537, 18488, 18440, 18391, 18342, 18293, 18244,
+  18195, 18145, 18096, 18046, 17997, 17947, 17897, 17848, 17798, 17747, 17697, 17647,
+  17596, 17546, 17495, 17444, 17394, 17343, 17292, 17240, 17189, 17138, 17086, 17034,
+  16983, 16931, 16879, 16826, 16774, 16722, 16669, 16616, 16564, 16511, 16458, 16404,
+  16351, 16298, 16244, 16190, 16136, 16082, 16028, 15974, 15919, 15865, 15810, 15755,
+  15700, 15644, 15589, 15534, 15478, 15422, 15366, 15310, 15253, 15197, 15140, 15083,
+  15026, 14969, 14911, 14854, 14796, 14738, 14680, 14621, 14563, 14504, 14445, 14386,
+  14326, 14267, 14207, 14147, 14087, 14026, 13966, 13905, 13844, 13782, 13721, 13659,
+  13597, 13535, 13472, 13409, 13346, 13283, 13219, 13156, 13092, 13027, 12963, 12898,
+  12832, 12767, 12701, 12635, 12569, 12502, 12435, 12368, 12300, 12232, 12164, 12095,
+  12026, 11957, 11887, 11817, 11746, 11675, 11604, 11533, 11461, 11388, 11315, 11242,
+  11168, 11094, 11020, 10945, 10869, 10793, 10716, 10639, 10562, 10484, 10405, 10326,
+  10247, 10166, 10086, 10004, 9922, 9839, 9756, 9672, 9587, 9502, 9416, 9329,
+  9241, 9153, 9064, 8974, 8883, 8791, 8699, 8605, 8510, 8415, 8318, 8221,
+  8122, 8022, 7921, 7818, 7715, 7610, 7503, 7395, 7286, 7175, 7062, 6948,
+  6831, 6713, 6593, 6471, 6346, 6219, 6089, 5956, 5821, 5683, 5541, 5395,
+  5246, 5092, 4933, 4770, 4600, 4425, 4242, 4051, 3850, 3639, 3415,
+};
+
+const uint16_t ikLutElbow[1127] PROGMEM = {
+  65535, 65408, 65282, 65159, 65037, 64917, 64799, 64683, 64568, 64455, 64343, 64233,
+  64123, 64015, 63909, 63803, 63699, 63596, 63494, 63393, 63293, 63194, 63095, 62998,
+  62902, 62806, 62712, 62618, 62525, 62433, 62341, 62251, 62161, 62071, 61983, 61895,
+  61807, 61721, 61635, 61549, 61464, 61380, 61296, 61213, 61130, 61048, 60967, 60885,
+  60805, 60725, 60645, 60566, 60487, 60409, 60331, 60254, 60177, 60100, 60024, 59948,
+  59873, 59798, 59723, 59649, 59575, 59502, 59429, 59356, 59284, 59212, 59140, 59068,
+  58997, 58927, 58856, 58786, 58716, 58647, 58577, 58508, 58440, 58371, 58303, 58235,
+  58168, 58101, 58033, 57967, 57900, 57834, 57768, 57702, 57637, 57571, 57506, 57441,
+  57377, 57313, 57248, 57184, 57121, 57057, 56994, 56931, 56868, 56806, 56743, 56681,
+  56619, 56557, 56495, 56434, 56373, 56312, 56251, 56190, 56129, 56069, 56009, 55949,
+  55889, 55829, 55770, 55711, 55651, 55592, 55534, 55475, 55417, 55358, 55300, 55242,
+  55184, 55126, 55069, 55011, 54954, 54897, 54840, 54783, 54726, 54670, 54613, 54557,
+  54501, 54445, 54389, 54333, 54277, 54222, 54167, 54111, 54056, 54001, 53946, 53892,
+  53837, 53782, 53728, 53674, 53620, 53565, 53512, 53458, 53404, 53350, 53297, 53244,
+  53190, 53137, 53084, 53031, 52978, 52926, 52873, 52820, 52768, 52716, 52663, 52611,
+  52559, 52507, 52455, 52404, 52352, 52300, 52249, 52198, 52146, 52095, 52044, 51993,
+  51942, 51891, 51841, 51790, 51739, 51689, 51638, 51588, 51538, 51488, 51438, 51388,
+  51338, 51288, 51238, 51189, 51139, 51089, 51040, 50991, 50941, 50892, 50843, 50794,
+  50745, 50696, 50647, 50598, 50550, 50501, 50453, 50404, 50356, 50307, 50259, 50211,
+  50163, 50115, 50067, 50019, 49971, 49923, 49875, 49828, 49780, 49733, 49685, 49638,
+  49590, 49543, 49496, 49449, 49401, 49354, 49307, 49260, 49214, 49167, 49120, 49073,
+  49027, 48980, 48933, 48887, 48841, 48794, 48748, 48702, 48655, 48609, 48563, 48517,
+  48471, 48425, 48379, 48333, 48288, 48242, 48196, 48151, 48105, 48059, 48014, 47968,
+  47923, 47878, 47832, 47787, 47742, 47697, 47652, 47607, 47562, 47517, 47472, 47427,
+  47382, 47337, 47292, 47248, 47203, 47158, 47114, 47069, 47025, 46980, 46936, 46892,
+  46847, 46803, 46759, 46714, 46670, 46626, 46582, 46538, 46494, 46450, 46406, 46362,
+  46318, 46275, 46231, 46187, 46143, 46100, 46056, 46012, 45969, 45925, 45882, 45838,
+  45795, 45752, 45708, 45665, 45622, 45578, 45535, 45492, 45449, 45406, 45363, 45320,
+  45277, 45234, 45191, 45148, 45105, 45062, 45019, 44976, 44934, 44891, 44848, 44805,
+  44763, 44720, 44678, 44635, 44592, 44550, 44507, 44465, 44423, 44380, 44338, 44296,
+  44253, 44211, 44169, 44126, 44084, 44042, 44000, 43958, 43916, 43874, 43832, 43790,
+  43748, 43706, 43664, 43622, 43580, 43538, 43496, 43454, 43412, 43371, 43329, 43287,
+  43245, 43204, 43162, 43120, 43079, 43037, 42996, 42954, 42913, 42871, 42830, 42788,
+  42747, 42705, 42664, 42622, 42581, 42540, 42498, 42457, 42416, 42374, 42333, 42292,
+  42251, 42210, 42168, 42127, 42086, 42045, 42004, 41963, 41922, 41881, 41840, 41799,
+  41758, 41717, 41676, 41635, 41594, 41553, 41512, 41471, 41430, 41389, 41349, 41308,
+  41267, 41226, 41185, 41145, 41104, 41063, 41022, 40982, 40941, 40900, 40860, 40819,
+  40778, 40738, 40697, 40657, 40616, 40575, 40535, 40494, 40454, 40413, 40373, 40332,
+  40292, 40251, 40211, 40171, 40130, 40090, 40049, 40009, 39968, 39928, 39888, 39847,
+  39807, 39767, 39726, 39686, 39646, 39605, 39565, 39525, 39485, 39444, 39404, 39364,
+  39324, 39283, 39243, 39203, 39163, 39123, 39082, 39042, 39002, 38962, 38922, 38882,
+  38842, 38801, 38761, 38721, 38681, 38641, 38601, 38561, 38521, 38481, 38441, 38401,
+  38360, 38320, 38280, 38240, 38200, 38160, 38120, 38080, 38040, 38000, 37960, 37920,
+  37880, 37840, 37800, 37760, 37720, 37680, 37640, 37600, 37560, 37521, 37481, 37441,
+  37401, 37361, 37321, 37281, 37241, 37201, 37161, 37121, 37081, 37041, 37001, 36961,
+  36921, 36882, 36842, 36802, 36762, 36722, 36682, 36642, 36602, 36562, 36522, 36482,
+  36442, 36403, 36363, 36323, 36283, 36243, 36203, 36163, 36123, 36083, 36043, 36003,
+  35963, 35924, 35884, 35844, 35804, 35764, 35724, 35684, 35644, 35604, 35564, 35524,
+  35484, 35444, 35404, 35364, 35325, 35285, 35245, 35205, 35165, 35125, 35085, 35045,
+  35005, 34965, 34925, 34885, 34845, 34805, 34765, 34725, 34685, 34645, 34605, 34565,
+  34525, 34484, 34444, 34404, 34364, 34324, 34284, 34244, 34204, 34164, 34124, 34084,
+  34044, 34003, 33963, 33923, 33883, 33843, 33803, 33762, 33722, 33682, 33642, 33602,
+  33561, 33521, 33481, 33441, 33401, 33360, 33320, 33280, 33239, 33199, 33159, 33119,
+  33078, 33038, 32998, 32957, 32917, 32876, 32836, 32796, 32755, 32715, 32674, 32634,
+  32593, 32553, 32512, 32472, 32431, 32391, 32350, 32310, 32269, 32229, 32188, 32148,
+  32107, 32066, 32026, 31985, 31944, 31904, 31863, 31822, 31782, 31741, 31700, 31659,
+  31619, 31578, 31537, 31496, 31455, 31414, 31374, 31333, 31292, 31251, 31210, 31169,
+  31128, 31087, 31046, 31005, 30964, 30923, 30882, 30841, 30800, 30759, 30717, 30676,
+  30635, 30594, 30553, 30511, 30470, 30429, 30388, 30346, 30305, 30264, 30222, 30181,
+  30139, 30098, 30056, 30015, 29973, 29932, 29890, 29849, 29807, 29766, 29724, 29682,
+  29641, 29599, 29557, 29516, 29474, 29432, 29390, 29348, 29306, 29265, 29223, 29181,
+  29139, 29097, 29055, 29013, 28971, 28929, 28887, 28844, 28802, 28760, 28718, 28676,
+  28633, 28591, 28549, 28506, 28464, 28422, 28379, 28337, 28294, 28252, 28209, 28167,
+  28124, 28081, 28039, 27996, 27953, 27911, 27868, 27825, 27782, 27739, 27696, 27653,
+  27610, 27567, 27524, 27481, 27438, 27395, 27352, 27309, 27266, 27222, 27179, 27136,
+  27092, 27049, 27005, 26962, 26918, 26875, 26831, 26788, 26744, 26700, 26657, 26613,
+  26569, 26525, 26481, 26438, 26394, 26350, 26306, 26262, 26217, 26173, 26129, 26085,
+  26041, 25996, 25952, 25908, 25863, 25819, 25774, 25730, 25685, 25640, 25596, 25551,
+  25506, 25461, 25417, 25372, 25327, 25282, 25237, 25192, 25146, 25101, 25056, 25011,
+  24966, 24920, 24875, 24829, 24784, 24738, 24693, 24647, 24601, 24555, 24510, 24464,
+  24418, 24372, 24326, 24280, 24234, 24188, 24141, 24095, 24049, 24002, 23956, 23909,
+  23863, 23816, 23770, 23723, 23676, 23629, 23582, 23535, 23488, 23441, 23394, 23347,
+  23300, 23252, 23205, 23157, 23110, 23062, 23015, 22967, 22919, 22871, 22824, 22776,
+  22728, 22680, 22631, 22583, 22535, 22486, 22438, 22390, 22341, 22292, 22244, 22195,
+  22146, 22097, 22048, 21999, 21950, 21901, 21851, 21802, 21752, 21703, 21653, 21604,
+  21554, 21504, 21454, 21404, 21354, 21304, 21253, 21203, 21153, 21102, 21052, 21001,
+  20950, 20899, 20848, 20797, 20746, 20695, 20644, 20592, 20541, 20489, 20437, 20386,
+  20334, 20282, 20230, 20178, 20125, 20073, 20020, 19968, 19915, 19862, 19810, 19757,
+  19703, 19650, 19597, 19544, 19490, 19436, 19383, 19329, 19275, 19221, 19167, 19112,
+  19058, 19003, 18949, 18894, 18839, 18784, 18729, 18673, 18618, 18562, 18507, 18451,
+  18395, 18339, 18283, 18226, 18170, 18113, 18056, 17999, 17942, 17885, 17828, 17770,
+  17713, 17655, 17597, 17539, 17481, 17422, 17364, 17305, 17246, 17187, 17128, 17069,
+  17009, 16949, 16889, 16829, 16769, 16709, 16648, 16587, 16526, 16465, 16404, 16342,
+  16281, 16219, 16157, 16094, 16032, 15969, 15906, 15843, 15780, 15716, 15653, 15589,
+  15524, 15460, 15395, 15330, 15265, 15200, 15134, 15068, 15002, 14936, 14869, 14802,
+  14735, 14668, 14600, 14532, 14464, 14396, 14327, 14258, 14189, 14119, 14049, 13979,
+  13908, 13837, 13766, 13695, 13623, 13551, 13478, 13405, 13332, 13258, 13184, 13110,
+  13035, 12960, 12885, 12809, 12733, 12656, 12579, 12501, 12423, 12345, 12266, 12187,
+  12107, 12027, 11946, 11865, 11783, 11700, 11618, 11534, 11450, 11366, 11281, 11195,
+  11109, 11022, 10934, 10846, 10757, 10668, 10577, 10486, 10395, 10302, 10209, 10115,
+  10020, 9924, 9828, 9730, 9632, 9532, 9432, 9330, 9228, 9124, 9020, 8914,
+  8807, 8699, 8589, 8478, 8366, 8252, 8136, 8020, 7901, 7781, 7658, 7534,
+  7408, 7280, 7150, 7017, 6882, 6744, 6603, 6460, 6313, 6163, 6009, 5851,
+  5689, 5522, 5350, 5173, 4989, 4799, 4600, 4393, 4176, 3947, 3704,
+};
+
+const uint16_t ikLutBearing[80] PROGMEM = {
+  0, 1056, 2112, 3167, 4221, 5274, 6325, 7374, 8421, 9465, 10506, 11544,
+  12579, 13609, 14635, 15657, 16674, 17686, 18693, 19694, 20690, 21679, 22663, 23640,
+  24610, 25574, 26530, 27480, 28422, 29356, 30283, 31202, 32114, 33017, 33912, 34799,
+  35678, 36549, 37410, 38264, 39109, 39945, 40773, 41592, 42403, 43205, 43998, 44782,
+  45558, 46325, 47084, 47833, 48575, 49307, 50031, 50747, 51454, 52153, 52843, 53526,
+  54200, 54865, 55523, 56173, 56814, 57448, 58074, 58692, 59303, 59906, 60501, 61089,
+  61670, 62243, 62809, 63368, 63920, 64465, 65004, 65535,
+};
+
+#endif
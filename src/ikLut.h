@@ -0,0 +1,20 @@
+#pragma once
+#include <Arduino.h>
+
+// Generated by tools/lutGen for L1 153, L2 161, R_MIN 50: do not edit.
+// Target 6.74e-05 rad, worst found 6.70e-05 rad, reach margin 1 mm.
+
+#define IK_LUT_L1 153.0
+#define IK_LUT_L2 161.0
+#define IK_LUT_R2_MIN 2500.00000f
+#define IK_LUT_R2_MAX 97969.0000f
+#define IK_LUT_R2_INV_STEP 0.0117944041f
+#define IK_LUT_RADIAL_N 1127
+#define IK_LUT_BEARING_N 80
+#define IK_LUT_SHOULDER_RAD 2.39807834e-05f // per count
+#define IK_LUT_ELBOW_RAD 4.31191225e-05f
+#define IK_LUT_BEARING_RAD 1.19844078e-05f
+
+extern const uint16_t ikLutShoulder[IK_LUT_RADIAL_N]; // acos term of the shoulder over r^2
+extern const uint16_t ikLutElbow[IK_LUT_RADIAL_N];    // minus the elbow angle over r^2
+extern const uint16_t ikLutBearing[IK_LUT_BEARING_N]; // atan over [0, 1]
@@ -72,6 +72,7 @@ void Interpolation::setInterpolation(const Point &p0, const Point &p1, float av)
     xPosmm = p1.xmm;
     yPosmm = p1.ymm;
     zPosmm = p1.zmm;
+    tmul = 0;
     state = 1;
     return;
   }
@@ -94,8 +95,11 @@ void Interpolation::setInterpolation(const Point &p0, const Point &p1, float av)
   yDelta = dy;
   zDelta = dz;
 
+  phase = 0;
+  progress = 0;
+  rate = held ? 0.0f : feedScale;
   state = 0;
-  startTime = micros();
+  lastTime = micros();
 }
 
 void Interpolation::updateActualPosition()
@@ -105,11 +109,21 @@ void Interpolation::updateActualPosition()
 
   // wrap-safe delta with uint32_t
   uint32_t now = micros();
-  float t = (float)(now - startTime) * 1e-6f; // seconds since start
-
-  // cosine ease-in/out in [0,1]
-  float u = t * tmul;
-  float progress = -cosf(u * PI) * 0.5f + 0.5f;
+  float dt = (float)(now - lastTime) * 1e-6f; // seconds since last update
+  lastTime = now;
+
+  // ramp the time scale towards the override, or to zero when held
+  float target = held ? 0.0f : feedScale;
+  float ramp = dt * (1.0f / FEED_RAMP_S);
+  if (rate < target)
+    rate = (rate + ramp < target) ? rate + ramp : target;
+  else if (rate > target)
+    rate = (rate - ramp > target) ? rate - ramp : target;
+
+  // cosine ease-in/out in [0,1], phase advances at the scaled rate
+  phase += dt * tmul * rate;
+  float u = phase;
+  progress = -cosf(u * PI) * 0.5f + 0.5f;
 
   if (u >= 1.0f)
   {
@@ -127,6 +141,48 @@ bool Interpolation::isFinished() const
   return state != 0;
 }
 
+float Interpolation::getDuration() const
+{
+  return (tmul > 0.0f) ? 1.0f / tmul : 0.0f;
+}
+
+void Interpolation::setFeedScale(float scale)
+{
+  feedScale = scale;
+}
+
+float Interpolation::getFeedScale() const
+{
+  return feedScale;
+}
+
+void Interpolation::hold()
+{
+  held = true;
+}
+
+void Interpolation::resume()
+{
+  held = false;
+}
+
+bool Interpolation::isHeld() const
+{
+  return held;
+}
+
+float Interpolation::getProgress() const
+{
+  return (state == 0) ? progress : 1.0f;
+}
+
+float Interpolation::getRemaining() const
+{
+  if (state != 0 || tmul <= 0.0f)
+    return 0.0f;
+  return (1.0f - phase) / (tmul * feedScale);
+}
+
 float Interpolation::getXPosmm() const
 {
   return xPosmm;
@@ -13,11 +13,11 @@ class Interpolation
 {
 public:
   Interpolation()
-      : state(1), startTime(0),
+      : state(1), held(false), lastTime(0),
         xStartmm(0), yStartmm(0), zStartmm(0),
         xDelta(0), yDelta(0), zDelta(0),
         xPosmm(0), yPosmm(0), zPosmm(0),
-        v(0), tmul(0) {}
+        v(0), tmul(0), phase(0), progress(1), rate(1), feedScale(1) {}
 
   void setCurrentPos(float px, float py, float pz);
   void setInterpolation(float px, float py, float pz, float v = 0);
@@ -30,6 +30,16 @@ public:
 
   void updateActualPosition();
   bool isFinished() const;
+  float getDuration() const;  // s, of the move last set
+  float getProgress() const;  // 0..1 of the path covered
+  float getRemaining() const; // s left at the current feed override
+
+  // Rescale the running move on the fly. Changes ramp in over FEED_RAMP_S.
+  void setFeedScale(float scale); // 1 = programmed feed
+  float getFeedScale() const;
+  void hold();   // decelerate to a standstill on the path
+  void resume(); // accelerate back to the scaled feed
+  bool isHeld() const;
 
   float getXPosmm() const;
   float getYPosmm() const;
@@ -37,12 +47,17 @@ public:
   Point getPosmm() const;
 
 private:
-  uint8_t state;      // 0=running, 1=finished/idle
-  uint32_t startTime; // micros() wrap-safe
+  uint8_t state;     // 0=running, 1=finished/idle
+  bool held;         // feed hold requested
+  uint32_t lastTime; // micros() of the previous update, wrap-safe
 
   float xStartmm, yStartmm, zStartmm;
   float xDelta, yDelta, zDelta;
   float xPosmm, yPosmm, zPosmm;
   float v;    // mm/s
   float tmul; // 1/s
+  float phase;     // 0..1 in time along the move
+  float progress;  // 0..1 along the path, eased
+  float rate;      // current time scale, ramps towards its target
+  float feedScale; // target time scale when not held
 };
@@ -0,0 +1,196 @@
+#pragma once
+#include <Arduino.h>
+#include "config.h"
+
+/*
+ * Kinematics backends. Every machine constant is constexpr and the derived
+ * values (squares, reciprocals, steps per radian) fold at compile time.
+ * The backend is picked by config.h and bound statically through the
+ * Kinematics typedef, so calls into it cost nothing extra.
+ */
+
+// Joint drive constants: steps per radian at the joint
+struct JointDrive
+{
+  static constexpr float higherStepsPerRad = (float)(HIGHER_GEAR_RATIO * STEPS_PER_REV / (2.0 * PI));
+  static constexpr float lowerStepsPerRad = (float)(LOWER_GEAR_RATIO * STEPS_PER_REV / (2.0 * PI));
+  static constexpr float rotateStepsPerRad = (float)(ROTATE_GEAR_RATIO * STEPS_PER_REV / (2.0 * PI));
+};
+
+// Geometry of the SCARA arm in config.h
+struct ScaraParams
+{
+  static constexpr float l1 = L1;
+  static constexpr float l2 = L2;
+  static constexpr float lead = LEAD;
+  static constexpr float coupling = HIGH_COUPLING;
+};
+
+template <class P>
+struct ScaraKinematics
+{
+  static constexpr float maxReach = P::l1 + P::l2;
+  static constexpr float lenSqSum = P::l1 * P::l1 + P::l2 * P::l2;
+  static constexpr float lenSqDiff = P::l1 * P::l1 - P::l2 * P::l2;
+  static constexpr float inv2L1 = 1.0f / (2.0f * P::l1);
+  static constexpr float inv2L1L2 = 1.0f / (2.0f * P::l1 * P::l2);
+  static constexpr float rotPerMm = (float)(-2.0 * PI) / P::lead;
+  static constexpr float parkedX = 135.0f; // elbow always down beyond this x
+
+  // Z is a pure screw on the rotate joint, independent of the plane
+  static float zToRot(float z) { return rotPerMm * z; }
+
+  static float clampUnit(float x)
+  {
+    return (x > 1.0f) ? 1.0f : ((x < -1.0f) ? -1.0f : x);
+  }
+
+  // choose elbow configuration (heuristic)
+  static void chooseElbow(float x, float y, bool &elbow)
+  {
+    if (x > 0 && y < maxReach)
+      elbow = false;
+    if (x > parkedX)
+      elbow = false; // parked region
+    if (x < 0 && y < maxReach)
+      elbow = true;
+  }
+
+  // Joint angles for a Cartesian point. elbow carries the branch choice
+  // between calls. Returns false if the point was out of reach and clamped.
+  static bool inverse(float x, float y, float z, bool &elbow, float &rot, float &low, float &high)
+  {
+    const float eps = 1e-6f;
+    bool reachable = true;
+    float distSq = x * x + y * y;
+    float dist = sqrtf(distSq);
+    if (dist > maxReach)
+    {
+      dist = maxReach - 1e-3f;
+      distSq = dist * dist;
+      reachable = false;
+    }
+
+    chooseElbow(x, y, elbow);
+
+    // reflect for elbow-up solution
+    if (elbow)
+      x = -x;
+
+    rot = zToRot(z);
+
+    // singularity at origin: shoulder pointing up, arm folded
+    if (dist < eps)
+    {
+      low = 0.0f;
+      high = (float)-PI;
+      return reachable;
+    }
+
+    // shoulder: direction plus law-of-cosines correction, minus mechanical offset
+    float d1 = atan2f(y, x);
+    float d2 = acosf(clampUnit((distSq + lenSqDiff) * inv2L1 / dist));
+    low = d1 + d2 - (float)(PI * 0.5);
+
+    // elbow: negative of PI - acos((L1^2+L2^2 - r^2)/(2 L1 L2))
+    high = acosf(clampUnit((lenSqSum - distSq) * inv2L1L2)) - (float)PI;
+
+    if (elbow)
+    {
+      low = -low;
+      high = -high;
+    }
+
+    // coupling gear ratio
+    high += P::coupling * low;
+    return reachable;
+  }
+
+  // Cartesian point for joint angles as inverse() returns them.
+  // The elbow branch is implied by the angles, so none is needed here.
+  static void forward(float rot, float low, float high, float &x, float &y, float &z)
+  {
+    float shoulder = low + (float)(PI * 0.5);
+    float elbowDir = shoulder + (high - P::coupling * low);
+    x = P::l1 * cosf(shoulder) + P::l2 * cosf(elbowDir);
+    y = P::l1 * sinf(shoulder) + P::l2 * sinf(elbowDir);
+    z = rot / rotPerMm;
+  }
+};
+
+// C++11 needs namespace-scope definitions for odr-used constexpr members
+template <class P>
+constexpr float ScaraKinematics<P>::maxReach;
+template <class P>
+constexpr float ScaraKinematics<P>::rotPerMm;
+
+#if defined(KINEMATICS_LUT)
+#include "ikLut.h"
+
+/*
+ * SCARA with the inverse read from flash tables (tools/lutGen). The elbow
+ * angle and the shoulder's law-of-cosines term only depend on r^2, the
+ * bearing is atan over the octant-reduced ratio, so a solve is three
+ * interpolated table reads and one divide. Outside the tabulated annulus
+ * (inside R_MIN, or within the margin of full reach) the exact solver runs.
+ */
+template <class P>
+struct LutKinematics : ScaraKinematics<P>
+{
+  typedef ScaraKinematics<P> Exact;
+
+  static float lerp(const uint16_t *table, uint16_t last, float f, float radPerCount)
+  {
+    uint16_t i = (uint16_t)f;
+    if (i >= last)
+      i = last - 1;
+    float a = pgm_read_word(&table[i]);
+    float b = pgm_read_word(&table[i + 1]);
+    return (a + (b - a) * (f - i)) * radPerCount;
+  }
+
+  static float bearing(float x, float y)
+  {
+    float ax = fabsf(x), ay = fabsf(y);
+    bool steep = ay > ax;
+    float t = steep ? ax / ay : ay / ax;
+    float a = lerp(ikLutBearing, IK_LUT_BEARING_N - 1, t * (IK_LUT_BEARING_N - 1), IK_LUT_BEARING_RAD);
+    if (steep)
+      a = (float)(PI * 0.5) - a;
+    if (x < 0)
+      a = (float)PI - a;
+    return (y < 0) ? -a : a;
+  }
+
+  static bool inverse(float x, float y, float z, bool &elbow, float &rot, float &low, float &high)
+  {
+    float distSq = x * x + y * y;
+    if (distSq < IK_LUT_R2_MIN || distSq >= IK_LUT_R2_MAX)
+      return Exact::inverse(x, y, z, elbow, rot, low, high);
+
+    Exact::chooseElbow(x, y, elbow);
+    if (elbow)
+      x = -x;
+    rot = Exact::zToRot(z);
+
+    float f = (distSq - IK_LUT_R2_MIN) * IK_LUT_R2_INV_STEP;
+    low = bearing(x, y) + lerp(ikLutShoulder, IK_LUT_RADIAL_N - 1, f, IK_LUT_SHOULDER_RAD) - (float)(PI * 0.5);
+    high = -lerp(ikLutElbow, IK_LUT_RADIAL_N - 1, f, IK_LUT_ELBOW_RAD);
+
+    if (elbow)
+    {
+      low = -low;
+      high = -high;
+    }
+    high += P::coupling * low;
+    return true;
+  }
+};
+
+static_assert(IK_LUT_L1 == L1 && IK_LUT_L2 == L2, "ikLut.h is for other arm lengths, rerun tools/lutGen");
+typedef LutKinematics<ScaraParams> Kinematics;
+#elif defined(KINEMATICS_SCARA)
+typedef ScaraKinematics<ScaraParams> Kinematics;
+#else
+#error "no kinematics backend selected in config.h"
+#endif
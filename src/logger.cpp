@@ -1,34 +1,59 @@
 #include "logger.h"
 #include "config.h"
 
-void Logger::log(String message, int level)
+Logger::Logger(Print &aout) : out(aout)
 {
-  if (LOG_LEVEL >= level)
+}
+
+// prints the level tag, false if the level is filtered out
+bool Logger::begin(int level)
+{
+  if (LOG_LEVEL < level)
+    return false;
+  switch (level)
+  {
+  case LOG_ERROR:
+    out.print("ERROR: ");
+    break;
+  case LOG_INFO:
+    out.print("INFO: ");
+    break;
+  case LOG_DEBUG:
+    out.print("DEBUG: ");
+    break;
+  }
+  return true;
+}
+
+void Logger::log(const char *message, int level)
+{
+  if (begin(level))
   {
-    switch (level)
-    {
-    case LOG_ERROR:
-      SERIALX.print("ERROR: ");
-      break;
-    case LOG_INFO:
-      SERIALX.print("INFO: ");
-      break;
-    case LOG_DEBUG:
-      SERIALX.print("DEBUG: ");
-      break;
-    }
-    SERIALX.println(message);
+    out.println(message);
   }
 }
-void Logger::logERROR(String message)
+void Logger::log(const char *prefix, long value, const char *suffix, int level)
+{
+  if (begin(level))
+  {
+    out.print(prefix);
+    out.print(value);
+    out.println(suffix);
+  }
+}
+void Logger::logERROR(const char *message)
 {
   log(message, LOG_ERROR);
 }
-void Logger::logINFO(String message)
+void Logger::logINFO(const char *message)
 {
   log(message, LOG_INFO);
 }
-void Logger::logDEBUG(String message)
+void Logger::logINFO(const char *prefix, long value, const char *suffix)
+{
+  log(prefix, value, suffix, LOG_INFO);
+}
+void Logger::logDEBUG(const char *message)
 {
   log(message, LOG_DEBUG);
 }
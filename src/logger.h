@@ -9,8 +9,15 @@
 class Logger
 {
 public:
-  static void log(String message, int level);
-  static void logINFO(String message);
-  static void logERROR(String message);
-  static void logDEBUG(String message);
+  Logger(Print &out);
+  void log(const char *message, int level);
+  void log(const char *prefix, long value, const char *suffix, int level); // e.g. "STORED: ", n, " BYTES"
+  void logINFO(const char *message);
+  void logINFO(const char *prefix, long value, const char *suffix = "");
+  void logERROR(const char *message);
+  void logDEBUG(const char *message);
+
+private:
+  bool begin(int level);
+  Print &out;
 };
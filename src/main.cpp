@@ -0,0 +1,42 @@
+#include "config.h"
+#include <Arduino.h>
+#include <Servo.h>
+#include "pinout.h"
+#include "kinematics.h"
+#include "robotArm.h"
+
+// STEPPER OBJECTS
+RampsStepper stepperHigher(X_STEP_PIN, X_DIR_PIN, X_ENABLE_PIN, INVERSE_X_STEPPER, JointDrive::higherStepsPerRad);
+RampsStepper stepperLower(Y_STEP_PIN, Y_DIR_PIN, Y_ENABLE_PIN, INVERSE_Y_STEPPER, JointDrive::lowerStepsPerRad);
+RampsStepper stepperRotate(Z_STEP_PIN, Z_DIR_PIN, Z_ENABLE_PIN, INVERSE_Z_STEPPER, JointDrive::rotateStepsPerRad);
+
+// EQUIPMENT OBJECTS
+Servo_Gripper servo_gripper(SERVO_PIN, SERVO_GRIP_DEGREE, SERVO_UNGRIP_DEGREE);
+Equipment led(LED_PIN);
+
+SerialTx serialTx(SERIALX);
+RobotArm robotArm(stepperHigher, stepperLower, stepperRotate, servo_gripper, led,
+                  serialTx, &Serial, &Serial2);
+
+Servo servo_motor;
+int angle = 45;
+int angle_offset = 0; // offset to compensate deviation from 90 degree(middle position)
+// which should gripper should be full closed.
+
+void setup()
+{
+  // various pins..
+  pinMode(LED_PIN, OUTPUT);
+
+  servo_motor.attach(SERVO_PIN);
+  servo_motor.write(angle + angle_offset);
+  delay(300);
+  servo_motor.detach();
+
+  robotArm.setup();
+}
+
+void loop()
+{
+  robotArm.loop();
+}
@@ -19,6 +19,18 @@
 #define Z_DIR_PIN 48
 #define Z_ENABLE_PIN 62
 
+#define X_MIN_PIN 3
+#define X_MAX_PIN 2
+#define Y_MIN_PIN 14
+#define Y_MAX_PIN 15
+#define Z_MIN_PIN 18
+#define Z_MAX_PIN 19
+
+// ENDSTOPS, ONE PER JOINT ON THE DRIVER'S MIN INPUT
+#define HIGHER_ENDSTOP_PIN X_MIN_PIN
+#define LOWER_ENDSTOP_PIN Y_MIN_PIN
+#define ROTATE_ENDSTOP_PIN Z_MIN_PIN
+
 #define SERVO_PIN 4
 
 #define LED_PIN 13
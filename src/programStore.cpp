@@ -0,0 +1,181 @@
+#include <Arduino.h>
+#include <string.h>
+#include "programStore.h"
+#include "storage.h"
+#include "config.h"
+
+#define PROGRAM_MAGIC 0xA7
+#define PROGRAM_HEADER 3
+#define OP_M 0x80
+#define OP_LONG_NUM 0x7F
+#define INSTRUCTION_MAX (1 + 2 + 1 + 6 * sizeof(float))
+
+enum
+{
+  STATE_IDLE,
+  STATE_RECORDING,
+  STATE_PLAYING
+};
+
+ProgramStore::ProgramStore()
+    : state(STATE_IDLE), length(0), position(0), loops(0)
+{
+}
+
+void ProgramStore::startRecording()
+{
+  // invalidate the stored program until recording is finished
+  Storage::write(PROGRAM_START, (uint8_t)0xFF);
+  length = 0;
+  position = 0;
+  state = STATE_RECORDING;
+}
+
+// Encodes one command. Returns false if it doesn't fit or can't be encoded.
+bool ProgramStore::record(const Cmd &cmd)
+{
+  if (state != STATE_RECORDING || cmd.num < 0 || cmd.num > 0xFFFF)
+    return false;
+
+  uint8_t buf[INSTRUCTION_MAX];
+  uint8_t n = 0;
+  uint8_t op = (cmd.id == 'M') ? OP_M : 0;
+  if (cmd.num < OP_LONG_NUM)
+  {
+    buf[n++] = op | cmd.num;
+  }
+  else
+  {
+    uint16_t num = cmd.num;
+    buf[n++] = op | OP_LONG_NUM;
+    memcpy(&buf[n], &num, sizeof(num));
+    n += sizeof(num);
+  }
+
+  // NAN/0 are the parser's "not given" values and are left out
+  const float values[6] = {cmd.valueX, cmd.valueY, cmd.valueZ, cmd.valueF, cmd.valueT, cmd.valueS};
+  const bool given[6] = {!isnan(cmd.valueX), !isnan(cmd.valueY), !isnan(cmd.valueZ),
+                         cmd.valueF != 0, cmd.valueT != 0, !isnan(cmd.valueS)};
+  uint8_t &mask = buf[n++];
+  mask = 0;
+  for (uint8_t i = 0; i < 6; i++)
+  {
+    if (given[i])
+    {
+      mask |= 1 << i;
+      memcpy(&buf[n], &values[i], sizeof(float));
+      n += sizeof(float);
+    }
+  }
+
+  if (PROGRAM_HEADER + position + n > PROGRAM_SIZE)
+  {
+    state = STATE_IDLE; // a partial program must never be played
+    return false;
+  }
+  Storage::write(PROGRAM_START + PROGRAM_HEADER + position, buf, n);
+  position += n;
+  return true;
+}
+
+bool ProgramStore::stopRecording()
+{
+  if (state != STATE_RECORDING)
+    return false;
+  length = position;
+  Storage::write(PROGRAM_START + 1, &length, sizeof(length));
+  Storage::write(PROGRAM_START, (uint8_t)PROGRAM_MAGIC);
+  state = STATE_IDLE;
+  return true;
+}
+
+bool ProgramStore::startPlayback(int aloops)
+{
+  if (state == STATE_RECORDING)
+    return false;
+  length = readLength();
+  if (length == 0)
+    return false;
+  loops = aloops;
+  position = 0;
+  state = STATE_PLAYING;
+  return true;
+}
+
+void ProgramStore::stopPlayback()
+{
+  if (state == STATE_PLAYING)
+    state = STATE_IDLE;
+}
+
+// Decodes the next instruction, wrapping around for the remaining passes.
+bool ProgramStore::next(Cmd &cmd)
+{
+  if (state != STATE_PLAYING)
+    return false;
+  if (position >= length)
+  {
+    if (loops > 0 && --loops == 0)
+    {
+      state = STATE_IDLE;
+      return false;
+    }
+    position = 0;
+  }
+
+  uint16_t addr = PROGRAM_START + PROGRAM_HEADER + position;
+  uint8_t op = Storage::read(addr++);
+  cmd.id = (op & OP_M) ? 'M' : 'G';
+  cmd.num = op & OP_LONG_NUM;
+  if (cmd.num == OP_LONG_NUM)
+  {
+    uint16_t num;
+    Storage::read(addr, &num, sizeof(num));
+    addr += sizeof(num);
+    cmd.num = num;
+  }
+
+  float values[6] = {NAN, NAN, NAN, 0, 0, NAN};
+  uint8_t mask = Storage::read(addr++);
+  for (uint8_t i = 0; i < 6; i++)
+  {
+    if (mask & (1 << i))
+    {
+      Storage::read(addr, &values[i], sizeof(float));
+      addr += sizeof(float);
+    }
+  }
+  cmd.valueX = values[0];
+  cmd.valueY = values[1];
+  cmd.valueZ = values[2];
+  cmd.valueF = values[3];
+  cmd.valueT = values[4];
+  cmd.valueS = values[5];
+
+  position = addr - (PROGRAM_START + PROGRAM_HEADER);
+  return true;
+}
+
+bool ProgramStore::isRecording() const
+{
+  return state == STATE_RECORDING;
+}
+
+bool ProgramStore::isPlaying() const
+{
+  return state == STATE_PLAYING;
+}
+
+uint16_t ProgramStore::getLength() const
+{
+  return length;
+}
+
+uint16_t ProgramStore::readLength() const
+{
+  if (Storage::read(PROGRAM_START) != PROGRAM_MAGIC)
+    return 0;
+  uint16_t len;
+  Storage::read(PROGRAM_START + 1, &len, sizeof(len));
+  return (len <= PROGRAM_SIZE - PROGRAM_HEADER) ? len : 0;
+}
@@ -0,0 +1,35 @@
+#pragma once
+#include <stdint.h>
+#include "command.h"
+
+// Stores a recorded G-code program in non-volatile memory as pre-parsed
+// bytecode and plays it back without touching the text parser.
+//
+// Layout at PROGRAM_START: magic (1 byte), code length (2 bytes), code.
+// Each instruction is
+//   op:   bit7 = 'M' else 'G', bits0-6 = number (0x7F: 16-bit number follows)
+//   mask: which of X Y Z F T S follow (bits 0-5)
+//   one float per set bit, in that order.
+class ProgramStore
+{
+public:
+  ProgramStore();
+  void startRecording();
+  bool record(const Cmd &cmd);
+  bool stopRecording();
+  bool startPlayback(int loops);
+  void stopPlayback();
+  bool next(Cmd &cmd);
+
+  bool isRecording() const;
+  bool isPlaying() const;
+  uint16_t getLength() const;
+
+private:
+  uint16_t readLength() const;
+
+  uint8_t state;     // 0=idle, 1=recording, 2=playing
+  uint16_t length;   // bytes of code
+  uint16_t position; // write position while recording, read position while playing
+  int loops;         // remaining passes, <= 0 repeats forever
+};
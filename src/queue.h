@@ -1,90 +1,96 @@
 #pragma once
 
-template <typename Element>
+// Ring buffer with its storage inline, sized at compile time
+template <typename Element, int N>
 class Queue
 {
 public:
-  Queue(int alen);
-  ~Queue();
+  Queue();
   bool push(Element elem);
   Element pop();
+  Element peek(int i) const; // i-th from the front, 0 is popped next
   bool isFull() const;
   bool isEmpty() const;
   int getFreeSpace() const;
   int getMaxLength() const;
   inline int getUsedSpace() const;
+  void clear();
 
 private:
-  Queue(Queue<Element> &q); // copy const.
-  Element *data;
-  int len;
+  Queue(Queue<Element, N> &q); // copy const.
+  Element data[N];
   int start;
   int count;
 };
 
-template <typename Element>
-Queue<Element>::Queue(int alen)
+template <typename Element, int N>
+Queue<Element, N>::Queue()
 {
-  data = new Element[alen];
-  len = alen;
   start = 0;
   count = 0;
 }
 
-template <typename Element>
-Queue<Element>::~Queue()
-{
-  delete data;
-}
-
-template <typename Element>
-Queue<Element>::Queue(Queue<Element> &q)
+template <typename Element, int N>
+Queue<Element, N>::Queue(Queue<Element, N> &q)
 {
   // nothing ever is allowed to do something here
 }
 
-template <typename Element>
-bool Queue<Element>::push(Element elem)
+template <typename Element, int N>
+bool Queue<Element, N>::push(Element elem)
 {
-  data[(start + count++) % len] = elem;
+  data[(start + count++) % N] = elem;
   return true;
 }
 
-template <typename Element>
-Element Queue<Element>::pop()
+template <typename Element, int N>
+Element Queue<Element, N>::pop()
 {
   count--;
   int s = start;
-  start = (start + 1) % len;
-  return data[(s) % len];
+  start = (start + 1) % N;
+  return data[(s) % N];
+}
+
+template <typename Element, int N>
+Element Queue<Element, N>::peek(int i) const
+{
+  return data[(start + i) % N];
 }
 
-template <typename Element>
-bool Queue<Element>::isFull() const
+template <typename Element, int N>
+bool Queue<Element, N>::isFull() const
 {
-  return count >= len;
+  return count >= N;
 }
 
-template <typename Element>
-bool Queue<Element>::isEmpty() const
+template <typename Element, int N>
+bool Queue<Element, N>::isEmpty() const
 {
   return count <= 0;
 }
 
-template <typename Element>
-int Queue<Element>::getFreeSpace() const
+template <typename Element, int N>
+int Queue<Element, N>::getFreeSpace() const
 {
-  return len - count;
+  return N - count;
 }
 
-template <typename Element>
-int Queue<Element>::getMaxLength() const
+template <typename Element, int N>
+int Queue<Element, N>::getMaxLength() const
 {
-  return len;
+  return N;
 }
 
-template <typename Element>
-int Queue<Element>::getUsedSpace() const
+template <typename Element, int N>
+int Queue<Element, N>::getUsedSpace() const
 {
   return count;
 }
+
+template <typename Element, int N>
+void Queue<Element, N>::clear()
+{
+  start = 0;
+  count = 0;
+}
@@ -1,52 +1,64 @@
-#include "config.h"
-#include <Arduino.h>
-#include <Stepper.h>
-#include <Servo.h>
-#include "pinout.h"
-#include "logger.h"
-#include "robotGeometry.h"
-#include "interpolation.h"
-#include "RampsStepper.h"
-#include "queue.h"
-#include "command.h"
-#include "servo_gripper.h"
-#include "equipment.h"
+#include "robotArm.h"
+#include "kinematics.h"
+#include "softLimits.h"
+#include "teachTable.h"
+#include "bench.h"
+#include "stackPaint.h"
 #include <math.h>
 
-static bool motionActive = false;
-
-// STEPPER OBJECTS
-RampsStepper stepperHigher(X_STEP_PIN, X_DIR_PIN, X_ENABLE_PIN, INVERSE_X_STEPPER, (62.0 / 16.0) * (62.0 / 33.0), 200 * 16);
-RampsStepper stepperLower(Y_STEP_PIN, Y_DIR_PIN, Y_ENABLE_PIN, INVERSE_Y_STEPPER, 72.0 / 16.0, 200 * 16);
-RampsStepper stepperRotate(Z_STEP_PIN, Z_DIR_PIN, Z_ENABLE_PIN, INVERSE_Z_STEPPER, 1.0, 200 * 16);
-
-// EQUIPMENT OBJECTS
-Servo_Gripper servo_gripper(SERVO_PIN, SERVO_GRIP_DEGREE, SERVO_UNGRIP_DEGREE);
-Equipment led(LED_PIN);
-
-RobotGeometry geometry;
-Interpolation interpolator;
-Queue<Cmd> queue(15);
-Command command;
-
-Servo servo_motor;
-int angle = 45;
-int angle_offset = 0; // offset to compensate deviation from 90 degree(middle position)
-// which should gripper should be full closed.
+RobotArm::RobotArm(RampsStepper &higher, RampsStepper &lower, RampsStepper &rotate,
+                   Servo_Gripper &gripper, Equipment &aled, SerialTx &atx,
+                   Stream *in, Stream *in2)
+    : stepperHigher(higher), stepperLower(lower), stepperRotate(rotate),
+      servo_gripper(gripper), led(aled), tx(atx),
+      command(&atx, in, in2), telemetry(atx), logger(atx), homing(higher, lower, rotate),
+      motionActive(false), moveClass(MOVE_COMBINED), executed(0), segmentActive(false), segmentSettle(false), segmentStart(0), segmentDuration(0),
+      rapidActive(false), rapidTarget(0), teachPending(-1), feedOverride(100), plannedX(INITIAL_X), plannedY(INITIAL_Y), plannedZ(INITIAL_Z)
+{
+}
 
-void cmdMove(const Cmd &cmd)
+void RobotArm::cmdMove(const Cmd &cmd)
 {
+  bool planar = fabsf(cmd.valueX - interpolator.getXPosmm()) > MOVE_EPS_MM ||
+                fabsf(cmd.valueY - interpolator.getYPosmm()) > MOVE_EPS_MM;
+  bool lift = fabsf(cmd.valueZ - interpolator.getZPosmm()) > MOVE_EPS_MM;
+  if (!planar && !lift)
+  {
+    // zero length: nothing to drive, outputs tied to it fire now
+    uint8_t action;
+    syncEvents.startMove();
+    while (syncEvents.finishMove(action))
+    {
+      fireSyncEvent(action);
+    }
+    return;
+  }
+  if (!planar && cmd.num == 0 && !syncEvents.isArmed())
+  {
+    // rapid lift/drop: the path is a straight line in joint space anyway,
+    // so run the rotate joint at its own limits (updateRapid())
+    rapidTarget = lroundf(Kinematics::zToRot(cmd.valueZ) * JointDrive::rotateStepsPerRad);
+    rapidEnd = Point(cmd.valueX, cmd.valueY, cmd.valueZ);
+    rapidActive = true;
+    stepperRotate.setSpeedScale(fminf(feedOverride * 0.01f, 1.0f));
+    startJointMove(stepperHigher.getTarget(), stepperLower.getTarget(), rapidTarget, 0, true);
+    return;
+  }
+  moveClass = !planar ? MOVE_Z : (!lift ? MOVE_PLANAR : MOVE_COMBINED);
+
   float v = (cmd.valueF > 0) ? (cmd.valueF / 60.0f) : 0.0f; // mm/s from mm/min
   interpolator.setInterpolation(cmd.valueX, cmd.valueY, cmd.valueZ, v);
+  syncEvents.startMove();
+  cpu.startMove(micros(), stepperHigher.getTarget(), stepperLower.getTarget(), stepperRotate.getTarget());
   motionActive = true; // <-- start driving IK
 }
 
-void cmdDwell(const Cmd &cmd)
+void RobotArm::cmdDwell(const Cmd &cmd)
 {
   delay((unsigned long)(cmd.valueT * 1000.0f));
 }
 
-void setStepperEnable(bool en)
+void RobotArm::setStepperEnable(bool en)
 {
   stepperRotate.enable(en);
   stepperLower.enable(en);
@@ -68,53 +80,606 @@ void setStepperEnable(bool en)
   }
 }
 
-void cmdStepperOn()
+void RobotArm::cmdStepperOn()
 {
   setStepperEnable(true);
 }
-void cmdStepperOff()
+void RobotArm::cmdStepperOff()
 {
   setStepperEnable(false);
 }
 
-void handleAsErr(const Cmd &cmd)
+void RobotArm::handleAsErr(const Cmd &cmd)
 {
-  printComment("Unknown Cmd " + String(cmd.id) + String(cmd.num) + " (queued)");
-  printFault();
+  tx.print("// Unknown Cmd ");
+  tx.print(cmd.id);
+  tx.print(cmd.num);
+  tx.println(" (queued)");
+  printFault(tx);
 }
 
-void homeSequence()
+void RobotArm::fireSyncEvent(uint8_t action)
 {
-  // 1) Seed joint step counters to your calibrated home steps
-  geometry.set(INITIAL_X, INITIAL_Y, INITIAL_Z);
-  stepperLower.setPositionRad(geometry.getLowRad());
-  stepperHigher.setPositionRad(geometry.getHighRad());
-  stepperRotate.setPositionRad(geometry.getRotRad());
+  switch (action)
+  {
+  case SYNC_GRIPPER_ON:
+    servo_gripper.startOn();
+    break;
+  case SYNC_GRIPPER_OFF:
+    servo_gripper.startOff();
+    break;
+  }
+}
+
+// G6: joint-space segment from the host G-code compiler. X/Y/Z are absolute
+// step targets for the higher/lower/rotate joints, T the duration in seconds.
+// No IK runs, each joint just steps at the rate that lands it on time.
+void RobotArm::cmdSegment(const Cmd &cmd)
+{
+  if (cmd.valueT <= 0 || isnan(cmd.valueX) || isnan(cmd.valueY) || isnan(cmd.valueZ))
+  {
+    handleAsErr(cmd);
+    return;
+  }
+  startJointMove(lroundf(cmd.valueX), lroundf(cmd.valueY), lroundf(cmd.valueZ), cmd.valueT, false);
+}
+
+// Steps the joints straight to their targets. With a duration each joint
+// runs at the constant rate that lands it on time, without one they
+// accelerate on their own limits. settle makes the next command wait for
+// the joints to arrive, not just for the time to be up.
+void RobotArm::startJointMove(int32_t higher, int32_t lower, int32_t rotate, float seconds, bool settle)
+{
+  if (seconds > 0)
+  {
+    int32_t most = labs(higher - stepperHigher.getPosition());
+    if (labs(lower - stepperLower.getPosition()) > most)
+      most = labs(lower - stepperLower.getPosition());
+    if (labs(rotate - stepperRotate.getPosition()) > most)
+      most = labs(rotate - stepperRotate.getPosition());
+    seconds = cpu.limitSegment(seconds, most);
+    float invT = 1.0f / seconds;
+    stepperHigher.stepToPositionAtRate(higher, labs(higher - stepperHigher.getPosition()) * invT);
+    stepperLower.stepToPositionAtRate(lower, labs(lower - stepperLower.getPosition()) * invT);
+    stepperRotate.stepToPositionAtRate(rotate, labs(rotate - stepperRotate.getPosition()) * invT);
+  }
+  else
+  {
+    stepperHigher.stepToPosition(higher);
+    stepperLower.stepToPosition(lower);
+    stepperRotate.stepToPosition(rotate);
+  }
+
+  // outputs synced to a segment fire as it starts, the compiler placed them
+  uint8_t action;
+  syncEvents.startMove();
+  while (syncEvents.finishMove(action))
+  {
+    fireSyncEvent(action);
+  }
+
+  segmentStart = micros();
+  segmentDuration = (seconds > 0) ? (uint32_t)(seconds * 1e6f) : 0;
+  segmentSettle = settle;
+  segmentActive = true;
+}
+
+// Feed hold brings a rapid to a standstill on the joint's ramp and cycle
+// start sends it on. The override (up to 100 %) scales its top speed, and
+// the logical Z follows the joint, so status and telemetry show where the
+// arm really is until the rapid is done.
+void RobotArm::updateRapid()
+{
+  if (interpolator.isHeld())
+  {
+    if (stepperRotate.getTarget() == rapidTarget)
+      stepperRotate.stop();
+  }
+  else if (stepperRotate.getTarget() != rapidTarget)
+  {
+    stepperRotate.stepToPosition(rapidTarget);
+  }
+  stepperRotate.setSpeedScale(fminf(feedOverride * 0.01f, 1.0f));
+  interpolator.setCurrentPos(interpolator.getXPosmm(), interpolator.getYPosmm(),
+                             stepperRotate.getPositionRad() / Kinematics::rotPerMm);
+}
+
+// The rapid has arrived, or was aborted: the joint gets its full speed back
+void RobotArm::finishRapid()
+{
+  rapidActive = false;
+  stepperRotate.setSpeedScale(1.0f);
+}
 
-  // 2) Seed logical XYZ to the same Cartesian home
-  interpolator.setCurrentPos(INITIAL_X, INITIAL_Y, INITIAL_Z);
+bool RobotArm::jointsOnPosition()
+{
+  return stepperHigher.isOnPosition() && stepperLower.isOnPosition() && stepperRotate.isOnPosition();
+}
 
-  // 3) Hold targets = current (no motion after homing)
-  stepperHigher.stepToPosition(stepperHigher.getPosition());
-  stepperLower.stepToPosition(stepperLower.getPosition());
-  stepperRotate.stepToPosition(stepperRotate.getPosition());
+// M700 S<index>: teach the current pose as a station. The EEPROM write
+// blocks for tens of ms, so loop() holds the queue and saves only once
+// the steppers have caught up with the pose (saveStation()).
+void RobotArm::cmdTeach(const Cmd &cmd)
+{
+  uint8_t index;
+  if (!TeachTable::slot(cmd.valueS, index))
+  {
+    handleAsErr(cmd);
+    return;
+  }
+  teachPending = index;
+}
 
-  // 4) Stop any active motion gating
-  motionActive = false; // and clear any axis flags if you added them
+void RobotArm::saveStation()
+{
+  uint8_t index = teachPending;
+  teachPending = -1;
+  TeachTable::save(index, interpolator.getXPosmm(), interpolator.getYPosmm(), interpolator.getZPosmm(),
+                   stepperHigher.getTarget(), stepperLower.getTarget(), stepperRotate.getTarget(),
+                   geometry.getElbow());
+  logger.logINFO("STATION ", (long)index, " SAVED");
+}
 
-  Logger::logINFO("HOMING COMPLETE");
+// Where an M701 to this slot ends, as seen at queue time: the pose of the
+// latest M700 to it still queued or waiting to save, else the stored one
+bool RobotArm::plannedStation(uint8_t index, float &x, float &y, float &z)
+{
+  uint8_t slot;
+  for (int i = queue.getUsedSpace() - 1; i >= 0; i--)
+  {
+    Cmd queued = queue.peek(i);
+    if (queued.id == 'M' && queued.num == 700 && TeachTable::slot(queued.valueS, slot) && slot == index)
+    {
+      x = queued.valueX;
+      y = queued.valueY;
+      z = queued.valueZ;
+      return true;
+    }
+  }
+  if (teachPending == index)
+  {
+    x = interpolator.getXPosmm();
+    y = interpolator.getYPosmm();
+    z = interpolator.getZPosmm();
+    return true;
+  }
+  TeachPoint point;
+  if (!TeachTable::load(index, point))
+    return false;
+  x = point.x;
+  y = point.y;
+  z = point.z;
+  return true;
 }
 
-void executeCommand(Cmd cmd)
+// M701 S<index> [T<seconds>]: go to a station on its stored joint steps,
+// no IK. Without T the joints move at their own top speed.
+void RobotArm::cmdStation(const Cmd &cmd)
+{
+  TeachPoint point;
+  uint8_t index;
+  if (!TeachTable::slot(cmd.valueS, index) || !TeachTable::load(index, point))
+  {
+    handleAsErr(cmd);
+    return;
+  }
+  startJointMove(point.higher, point.lower, point.rotate, cmd.valueT, true);
+  interpolator.setCurrentPos(point.x, point.y, point.z);
+  geometry.setElbow(TeachTable::elbow(point));
+}
+
+// G92: redefine the logical Cartesian position without moving
+void RobotArm::cmdSetPosition(const Cmd &cmd)
+{
+  interpolator.setCurrentPos(cmd.valueX, cmd.valueY, cmd.valueZ);
+}
+
+// Position (forward kinematics on the actual joint steps), joint steps,
+// queue fill and free input buffer, in one line:
+// <Run|MPos:x,y,z|J:higher,lower,rotate|Q:used/size|Bf:queue,rx|Ov:percent>
+void RobotArm::reportStatus()
+{
+  float x, y, z;
+  Kinematics::forward(stepperRotate.getPositionRad(), stepperLower.getPositionRad(),
+                      stepperHigher.getPositionRad(), x, y, z);
+
+  const char *state = "Idle";
+  if (interpolator.isHeld())
+    state = "Hold";
+  else if (homing.isActive())
+    state = "Home";
+  else if (motionActive || segmentActive)
+    state = "Run";
+  else if (programStore.isRecording())
+    state = "Rec";
+
+  tx.print('<');
+  tx.print(state);
+  tx.print("|MPos:");
+  tx.print(x, 2);
+  tx.print(',');
+  tx.print(y, 2);
+  tx.print(',');
+  tx.print(z, 2);
+  tx.print("|J:");
+  tx.print(stepperHigher.getPosition());
+  tx.print(',');
+  tx.print(stepperLower.getPosition());
+  tx.print(',');
+  tx.print(stepperRotate.getPosition());
+  tx.print("|Q:");
+  tx.print(queue.getUsedSpace());
+  tx.print('/');
+  tx.print(queue.getMaxLength());
+  tx.print("|Bf:");
+  tx.print(queue.getFreeSpace());
+  tx.print(',');
+  tx.print(command.getRxFree());
+  tx.print("|Ov:");
+  tx.print(feedOverride);
+  if (programStore.isPlaying())
+    tx.print("|Play");
+  tx.println('>');
+}
+
+void RobotArm::sendTelemetry(uint32_t now)
+{
+  TelemetryFrame frame;
+  frame.timeUs = now;
+  frame.higher = stepperHigher.getPosition();
+  frame.lower = stepperLower.getPosition();
+  frame.rotate = stepperRotate.getPosition();
+  frame.xmm = interpolator.getXPosmm();
+  frame.ymm = interpolator.getYPosmm();
+  frame.zmm = interpolator.getZPosmm();
+  frame.queue = queue.getUsedSpace();
+  telemetry.send(frame);
+}
+
+// M154 S<Hz>: binary telemetry frames at a fixed rate, S0 stops them
+void RobotArm::cmdTelemetry(const Cmd &cmd)
+{
+  telemetry.setRate(isnan(cmd.valueS) ? 0 : cmd.valueS);
+}
+
+// M3/M5 without parameters act now. With S<percent> they fire at that
+// point of the next move's path, with T<seconds> that long before it ends.
+void RobotArm::cmdGripper(const Cmd &cmd, bool on)
+{
+  if (isnan(cmd.valueS) && cmd.valueT <= 0)
+  {
+    if (on)
+      servo_gripper.cmdOn();
+    else
+      servo_gripper.cmdOff();
+    return;
+  }
+  uint8_t action = on ? SYNC_GRIPPER_ON : SYNC_GRIPPER_OFF;
+  bool armed = isnan(cmd.valueS) ? syncEvents.arm(action, SYNC_BEFORE_END, cmd.valueT)
+                                 : syncEvents.arm(action, SYNC_AT_PROGRESS, cmd.valueS * 0.01f);
+  if (!armed)
+    handleAsErr(cmd);
+}
+
+void RobotArm::setFeedOverride(int percent)
+{
+  if (percent < FEED_OVERRIDE_MIN)
+    percent = FEED_OVERRIDE_MIN;
+  if (percent > FEED_OVERRIDE_MAX)
+    percent = FEED_OVERRIDE_MAX;
+  feedOverride = percent;
+  applyFeedScale();
+}
+
+// The override as asked for, held down by the CPU budget if need be
+void RobotArm::applyFeedScale()
+{
+  interpolator.setFeedScale(feedOverride * 0.01f * cpu.getFeedCap());
+}
+
+// M220 S<percent>: feed override from the program
+void RobotArm::cmdFeedOverride(const Cmd &cmd)
+{
+  if (isnan(cmd.valueS))
+  {
+    handleAsErr(cmd);
+    return;
+  }
+  setFeedOverride(lroundf(cmd.valueS));
+}
+
+// Stops everything without losing track of where the arm is: joints
+// decelerate on their own limits and the logical position follows them.
+void RobotArm::abortMotion()
+{
+  queue.clear();
+  command.flush();
+  programStore.stopPlayback();
+  syncEvents.clear();
+  homing.abort();
+
+  stepperHigher.stop();
+  stepperLower.stop();
+  stepperRotate.stop();
+  float x, y, z;
+  Kinematics::forward(stepperRotate.getTargetRad(), stepperLower.getTargetRad(),
+                      stepperHigher.getTargetRad(), x, y, z);
+  interpolator.setCurrentPos(x, y, z);
+  interpolator.resume();
+  motionActive = false;
+  segmentActive = false;
+  finishRapid();
+  teachPending = -1;
+
+  logger.logINFO("ABORTED");
+}
+
+void RobotArm::handleRealtime()
+{
+  uint16_t rt = command.getRealtime();
+  if (rt & RT_ABORT)
+    abortMotion();
+  if (rt & RT_FEED_HOLD)
+    interpolator.hold();
+  if (rt & RT_CYCLE_START)
+    interpolator.resume();
+  if (rt & RT_OVR_RESET)
+    setFeedOverride(100);
+  if (rt & RT_OVR_STEP)
+    setFeedOverride(feedOverride + command.takeOverrideSteps());
+  command.clearRealtime(rt & ~(RT_STATUS_REPORT | RT_OVR_STEP));
+}
+
+// M122: loop timing, everything that got throttled or dropped so far and
+// the RAM high-water mark. M122 S0 clears the counters.
+void RobotArm::cmdDiagnostics(const Cmd &cmd)
+{
+  tx.print("// loop avg ");
+  tx.print(cpu.getLoopAvgUs());
+  tx.print("us max ");
+  tx.print(cpu.getLoopMaxUs());
+  tx.print("us, step limit ");
+  tx.print((long)cpu.getStepLimit());
+  tx.println("/s");
+  tx.print("// throttled ");
+  tx.print(cpu.getThrottleCount());
+  tx.print("x for ");
+  tx.print(cpu.getThrottleMs());
+  tx.print("ms, feed cap ");
+  tx.print((int)(cpu.getFeedCap() * 100.0f + 0.5f));
+  tx.print("%, deadline misses ");
+  tx.print(cpu.getDeadlineMisses());
+  tx.print(", segments stretched ");
+  tx.println(cpu.getStretchedSegments());
+  tx.print("// tx overflow ");
+  tx.print(tx.getOverflowCount());
+  tx.print(", telemetry dropped ");
+  tx.println(telemetry.getDropped());
+  tx.print("// ram static ");
+  tx.print(StackPaint::staticBytes());
+  tx.print(", stack peak ");
+  tx.print(StackPaint::peakBytes());
+  tx.print(", never used ");
+  tx.print(StackPaint::freeBytes());
+  tx.println(" bytes");
+  if (!isnan(cmd.valueS) && cmd.valueS == 0)
+    cpu.clearCounters();
+}
+
+// Only the standard rates: after any other the host could be left unable
+// to match the UART's actual rate, with no way to send M575 again.
+static bool isStandardBaud(unsigned long baud)
+{
+  switch (baud)
+  {
+  case 9600:
+  case 19200:
+  case 38400:
+  case 57600:
+  case 115200:
+  case 230400:
+  case 250000:
+  case 500000:
+  case MAX_BAUD:
+    return true;
+  default:
+    return false;
+  }
+}
+
+void RobotArm::cmdSetBaud(const Cmd &cmd)
+{
+  unsigned long baud = (cmd.valueS > 0 && cmd.valueS <= MAX_BAUD) ? (unsigned long)cmd.valueS : 0;
+  if (baud != cmd.valueS || !isStandardBaud(baud))
+  {
+    handleAsErr(cmd);
+    return;
+  }
+  printComment(tx, "baud ", (long)baud);
+  tx.setBaud(baud); // reply above goes out at the old rate
+}
+
+void RobotArm::cmdRecordStart()
+{
+  programStore.startRecording();
+  logger.logINFO("RECORDING PROGRAM");
+}
+
+void RobotArm::cmdRecordStop()
+{
+  if (!programStore.stopRecording())
+  {
+    printFault(tx);
+    return;
+  }
+  logger.logINFO("PROGRAM STORED: ", programStore.getLength(), " BYTES");
+}
+
+void RobotArm::recordCommand(const Cmd &cmd)
+{
+  // program control can't be part of a program
+  if (cmd.id == 'M' && (cmd.num == 24 || cmd.num == 25 || cmd.num == 28))
+  {
+    handleAsErr(cmd);
+    return;
+  }
+  Cmd stored = cmd;
+  if (cmd.id == 'M' && cmd.num == 700)
+    stored.valueX = stored.valueY = stored.valueZ = NAN; // the pose queueCommand() added
+  if (!programStore.record(stored))
+  {
+    logger.logERROR("PROGRAM FULL, RECORDING ABORTED");
+    printFault(tx);
+  }
+}
+
+void RobotArm::cmdPlay(const Cmd &cmd)
+{
+  int loops = isnan(cmd.valueS) ? 0 : (int)cmd.valueS; // S<passes>, default forever
+  if (!programStore.startPlayback(loops))
+  {
+    logger.logERROR("NO PROGRAM STORED");
+    printFault(tx);
+  }
+}
+
+void RobotArm::cmdStopPlay()
+{
+  programStore.stopPlayback();
+}
+
+void RobotArm::homeSequence()
+{
+  setStepperEnable(true);
+  logger.logINFO("HOMING");
+  homing.start();
+}
+
+// All joints latched: park at the start pose and take the Cartesian
+// position from the joints (forward kinematics), not from assumptions.
+void RobotArm::finishHoming()
+{
+  if (homing.hasFailed())
+  {
+    abortMotion();
+    logger.logERROR("HOMING FAILED");
+    printFault(tx);
+    return;
+  }
+
+  geometry.set(INITIAL_X, INITIAL_Y, INITIAL_Z);
+  startJointMove(lroundf(geometry.getHighRad() * JointDrive::higherStepsPerRad),
+                 lroundf(geometry.getLowRad() * JointDrive::lowerStepsPerRad),
+                 lroundf(geometry.getRotRad() * JointDrive::rotateStepsPerRad), 0, true);
+
+  float x, y, z;
+  Kinematics::forward(stepperRotate.getTargetRad(), stepperLower.getTargetRad(),
+                      stepperHigher.getTargetRad(), x, y, z);
+  interpolator.setCurrentPos(x, y, z);
+
+  logger.logINFO("HOMING COMPLETE");
+}
+
+// Moves are checked against the soft limits from the end of the previous
+// queued move, once, so the motion loop never meets an unreachable point.
+void RobotArm::queueCommand(const Cmd &cmd)
+{
+  if (cmd.id == 'G' && (cmd.num == 0 || cmd.num == 1 || cmd.num == 92))
+  {
+    float x = isnan(cmd.valueX) ? plannedX : cmd.valueX;
+    float y = isnan(cmd.valueY) ? plannedY : cmd.valueY;
+    float z = isnan(cmd.valueZ) ? plannedZ : cmd.valueZ;
+    uint8_t error = (cmd.num == 92) ? SoftLimits::checkPoint(x, y, z)
+                                    : SoftLimits::checkMove(plannedX, plannedY, plannedZ, x, y, z);
+    if (error != LIMIT_OK)
+    {
+      printComment(tx, "Move rejected: ", SoftLimits::describe(error));
+      printFault(tx);
+      return;
+    }
+    plannedX = x;
+    plannedY = y;
+    plannedZ = z;
+  }
+  else if (cmd.id == 'G' && cmd.num == 6 && !isnan(cmd.valueX) && !isnan(cmd.valueY) && !isnan(cmd.valueZ))
+  {
+    // segments are only checked where they end, the compiler checked the path
+    float x, y, z;
+    uint8_t error = SoftLimits::checkJointPoint(lroundf(cmd.valueZ) / JointDrive::rotateStepsPerRad,
+                                                lroundf(cmd.valueY) / JointDrive::lowerStepsPerRad,
+                                                lroundf(cmd.valueX) / JointDrive::higherStepsPerRad, x, y, z);
+    if (error != LIMIT_OK)
+    {
+      printComment(tx, "Move rejected: ", SoftLimits::describe(error));
+      printFault(tx);
+      return;
+    }
+    plannedX = x;
+    plannedY = y;
+    plannedZ = z;
+  }
+  else if (cmd.id == 'G' && cmd.num == 28)
+  {
+    // the park pose comes from config.h, the joints go there straight from the switches
+    uint8_t error = SoftLimits::checkPoint(INITIAL_X, INITIAL_Y, INITIAL_Z);
+    if (error != LIMIT_OK)
+    {
+      printComment(tx, "Move rejected: ", SoftLimits::describe(error));
+      printFault(tx);
+      return;
+    }
+    plannedX = INITIAL_X;
+    plannedY = INITIAL_Y;
+    plannedZ = INITIAL_Z;
+  }
+  else if (cmd.id == 'M' && cmd.num == 700)
+  {
+    // carries the pose it will teach, for an M701 queued behind it
+    Cmd teach = cmd;
+    teach.valueX = plannedX;
+    teach.valueY = plannedY;
+    teach.valueZ = plannedZ;
+    queue.push(teach);
+    return;
+  }
+  else if (cmd.id == 'M' && cmd.num == 701)
+  {
+    // stations were inside the limits when taught
+    uint8_t index;
+    float x, y, z;
+    if (TeachTable::slot(cmd.valueS, index) && plannedStation(index, x, y, z))
+    {
+      plannedX = x;
+      plannedY = y;
+      plannedZ = z;
+    }
+  }
+  queue.push(cmd);
+}
+
+void RobotArm::executeCommand(Cmd cmd)
 {
   if (cmd.id == -1)
   {
-    String msg = "parsing Error";
-    printComment(msg);
+    printComment(tx, "parsing Error");
     handleAsErr(cmd);
     return;
   }
 
+  // while recording, everything but M29 goes to storage instead of the machine
+  if (programStore.isRecording() && !(cmd.id == 'M' && cmd.num == 29))
+  {
+    recordCommand(cmd);
+    return;
+  }
+
+  // segments carry joint steps, not Cartesian values
+  if (cmd.id == 'G' && cmd.num == 6)
+  {
+    cmdSegment(cmd);
+    return;
+  }
+
   if (isnan(cmd.valueX))
     cmd.valueX = interpolator.getXPosmm();
   if (isnan(cmd.valueY))
@@ -139,6 +704,9 @@ void executeCommand(Cmd cmd)
     case 28:
       homeSequence();
       break;
+    case 92:
+      cmdSetPosition(cmd);
+      break;
     default:
       handleAsErr(cmd);
     }
@@ -148,10 +716,34 @@ void executeCommand(Cmd cmd)
     switch (cmd.num)
     {
     case 3:
-      servo_gripper.cmdOn();
+      cmdGripper(cmd, true);
       break;
     case 5:
-      servo_gripper.cmdOff();
+      cmdGripper(cmd, false);
+      break;
+    case 24:
+      cmdPlay(cmd);
+      break;
+    case 25:
+      cmdStopPlay();
+      break;
+    case 28:
+      cmdRecordStart();
+      break;
+    case 29:
+      cmdRecordStop();
+      break;
+    case 114:
+      reportStatus();
+      break;
+    case 122:
+      cmdDiagnostics(cmd);
+      break;
+    case 154:
+      cmdTelemetry(cmd);
+      break;
+    case 220:
+      cmdFeedOverride(cmd);
       break;
     case 17:
       cmdStepperOn();
@@ -159,6 +751,15 @@ void executeCommand(Cmd cmd)
     case 18:
       cmdStepperOff();
       break;
+    case 575:
+      cmdSetBaud(cmd);
+      break;
+    case 700:
+      cmdTeach(cmd);
+      break;
+    case 701:
+      cmdStation(cmd);
+      break;
     default:
       handleAsErr(cmd);
     }
@@ -169,60 +770,133 @@ void executeCommand(Cmd cmd)
   }
 }
 
-void setup()
+void RobotArm::setup()
 {
-  SERIALX.begin(BAUD);
-
-  // various pins..
-  pinMode(LED_PIN, OUTPUT);
+  tx.begin(BAUD);
+  homing.setup();
 
-  servo_motor.attach(SERVO_PIN);
-  servo_motor.write(angle + angle_offset);
-  delay(300);
-  servo_motor.detach();
-
-  stepperHigher.setPositionRad(0);
-  stepperLower.setPositionRad(PI / 2.0); // 90°
-  stepperRotate.setPositionRad((PI * 2) * GRIPPERFLOATHEIGHT / LEAD);
+  // Until G28 finds the real pose, the counters assume the arm is where
+  // homing parks it, which is also where the interpolator starts. That
+  // keeps unhomed runs (G92 in benches and simulations) consistent.
+  geometry.set(INITIAL_X, INITIAL_Y, INITIAL_Z);
+  stepperHigher.setPositionRad(geometry.getHighRad());
+  stepperLower.setPositionRad(geometry.getLowRad());
+  stepperRotate.setPositionRad(geometry.getRotRad());
 
   // enable and init..
 
   setStepperEnable(false); // ROBOT ADJUSTABLE BY HAND AFTER TURNING ON
-  Logger::logINFO("ROBOT ONLINE");
-  Logger::logINFO("HOME ROBOT MANUALLY");
+  logger.logINFO("ROBOT ONLINE");
+  logger.logINFO("HOME ROBOT WITH G28");
 
   interpolator.setInterpolation(INITIAL_X, INITIAL_Y, INITIAL_Z, INITIAL_X, INITIAL_Y, INITIAL_Z);
 
-  SERIALX.println("started");
+  tx.println("started");
 }
 
-void loop()
+void RobotArm::loop()
 {
+  BENCH_MARK(BENCH_LOOP_START);
+
   // 1) ALWAYS tick the steppers first. This is the highest priority.
   stepperRotate.update();
   stepperLower.update();
   stepperHigher.update();
+  BENCH_MARK(BENCH_STEPPERS_DONE);
+
+  uint32_t now = micros();
+  telemetry.tick(cpu.tick(now));
+
+  // Push queued output into the UART without ever waiting on it.
+  tx.update();
+  servo_gripper.update();
+
+  // Real-time requests are answered right away, moving or not. The reply
+  // waits (without blocking) until it fits in the output buffer whole.
+  command.receive();
+  handleRealtime();
+  if ((command.getRealtime() & RT_STATUS_REPORT) && tx.availableForWrite() >= STATUS_REPORT_MAX)
+  {
+    command.clearRealtime(RT_STATUS_REPORT);
+    reportStatus();
+  }
+  if (telemetry.due(now))
+  {
+    sendTelemetry(now);
+  }
+  BENCH_MARK(BENCH_IO_DONE);
 
   // 2) If the interpolator is finished, the machine is idle.
   //    We can process serial, pop a command from the queue, and handle LEDs.
   if (interpolator.isFinished())
   {
-    // Stop motion gating if it was active
+    // Stop motion gating if it was active, firing synced outputs the
+    // move ended too early for
     if (motionActive)
     {
       motionActive = false;
+      uint8_t action;
+      while (syncEvents.finishMove(action))
+      {
+        fireSyncEvent(action);
+      }
+    }
+
+    // Nothing planned ahead: moves get checked from where the arm is.
+    if (queue.isEmpty() && !segmentActive)
+    {
+      plannedX = interpolator.getXPosmm();
+      plannedY = interpolator.getYPosmm();
+      plannedZ = interpolator.getZPosmm();
     }
 
     // Check for and process incoming G-code commands ONLY when idle.
     if (!queue.isFull() && command.handleGcode())
     {
-      queue.push(command.getCmd());
+      queueCommand(command.getCmd());
+    }
+
+    // Feed the stored program, already decoded, while playback runs.
+    Cmd stored;
+    if (!queue.isFull() && programStore.next(stored))
+    {
+      queueCommand(stored);
+    }
+
+    // A running G6 segment needs no IK, so input keeps flowing while it
+    // runs; the next command waits for the segment's time to be up.
+    if (rapidActive)
+    {
+      updateRapid();
+    }
+    if (segmentActive && (uint32_t)(micros() - segmentStart) >= segmentDuration &&
+        (!segmentSettle || jointsOnPosition()) && (!rapidActive || stepperRotate.getPosition() == rapidTarget))
+    {
+      segmentActive = false;
+      if (rapidActive)
+      {
+        finishRapid();
+        interpolator.setCurrentPos(rapidEnd);
+      }
+    }
+
+    // G28 holds the queue until every joint has latched
+    if (homing.isActive() && !homing.update())
+    {
+      finishHoming();
+    }
+
+    // M700 saves once the joints stand on the taught pose
+    if (teachPending >= 0 && jointsOnPosition())
+    {
+      saveStation();
     }
 
     // If there's a command in the queue, execute it.
-    if (!queue.isEmpty())
+    if (!segmentActive && teachPending < 0 && !homing.isActive() && !interpolator.isHeld() && !queue.isEmpty())
     {
       executeCommand(queue.pop()); // This will set motionActive=true for G0/G1
+      executed++;
     }
 
     // Handle non-time-critical things like LEDs
@@ -235,15 +909,60 @@ void loop()
       led.cmdOff();
     }
   }
+  BENCH_MARK(BENCH_IDLE_DONE);
 
   // 3) If motion is active, update the interpolator and feed new targets to IK.
   //    This block only runs during a move.
   if (motionActive)
   {
     interpolator.updateActualPosition();
-    geometry.set(interpolator.getXPosmm(), interpolator.getYPosmm(), interpolator.getZPosmm());
-    stepperRotate.stepToPositionRad(geometry.getRotRad());
-    stepperLower.stepToPositionRad(geometry.getLowRad());
-    stepperHigher.stepToPositionRad(geometry.getHighRad());
+    uint8_t action;
+    while (syncEvents.poll(interpolator.getProgress(), interpolator.getRemaining(), action))
+    {
+      fireSyncEvent(action);
+    }
+    switch (moveClass)
+    {
+    case MOVE_Z:
+      stepperRotate.stepToPositionRad(Kinematics::zToRot(interpolator.getZPosmm()));
+      break;
+    case MOVE_PLANAR:
+      geometry.set(interpolator.getXPosmm(), interpolator.getYPosmm(), interpolator.getZPosmm());
+      stepperLower.stepToPositionRad(geometry.getLowRad());
+      stepperHigher.stepToPositionRad(geometry.getHighRad());
+      break;
+    default:
+      geometry.set(interpolator.getXPosmm(), interpolator.getYPosmm(), interpolator.getZPosmm());
+      stepperRotate.stepToPositionRad(geometry.getRotRad());
+      stepperLower.stepToPositionRad(geometry.getLowRad());
+      stepperHigher.stepToPositionRad(geometry.getHighRad());
+      break;
+    }
+    if (cpu.track(micros(), stepperHigher.getTarget(), stepperLower.getTarget(), stepperRotate.getTarget()))
+    {
+      applyFeedScale();
+    }
   }
+  BENCH_MARK(BENCH_MOTION_DONE);
+}
+
+bool RobotArm::isIdle()
+{
+  return !motionActive && !segmentActive && teachPending < 0 && !homing.isActive() && queue.isEmpty() &&
+         !programStore.isPlaying() && command.isRxEmpty() && jointsOnPosition();
+}
+
+bool RobotArm::isStarved()
+{
+  return !motionActive && !segmentActive && teachPending < 0 && !homing.isActive() && queue.isEmpty();
+}
+
+int RobotArm::getRxFree() const
+{
+  return command.getRxFree();
+}
+
+uint32_t RobotArm::getExecuted() const
+{
+  return executed;
 }
@@ -0,0 +1,130 @@
+#pragma once
+#include <Arduino.h>
+#include "config.h"
+#include "logger.h"
+#include "robotGeometry.h"
+#include "interpolation.h"
+#include "RampsStepper.h"
+#include "queue.h"
+#include "command.h"
+#include "servo_gripper.h"
+#include "equipment.h"
+#include "serialTx.h"
+#include "programStore.h"
+#include "telemetry.h"
+#include "syncEvents.h"
+#include "cpuBudget.h"
+#include "homing.h"
+
+// What a G0/G1 changes, picks the kernel that drives it
+enum MoveClass
+{
+  MOVE_Z,       // rotate joint only, no planar IK
+  MOVE_PLANAR,  // XY only, rotate joint holds
+  MOVE_COMBINED // full pipeline
+};
+
+// One complete arm controller: G-code input, planning and the motion loop.
+// The hardware it drives (steppers, gripper, LED) and the serial link are
+// passed in, time comes from micros()/millis(). The firmware builds one
+// instance on the RAMPS pins, host tools can build as many as they like.
+class RobotArm
+{
+public:
+  RobotArm(RampsStepper &higher, RampsStepper &lower, RampsStepper &rotate,
+           Servo_Gripper &gripper, Equipment &led, SerialTx &tx,
+           Stream *in, Stream *in2 = NULL);
+  void setup();
+  void loop();
+
+  // Nothing moving, queued or waiting in the input buffer
+  bool isIdle();
+
+  // Nothing running and nothing queued to run next
+  bool isStarved();
+
+  // Room left for G-code in the input buffer, as reported in Bf:
+  int getRxFree() const;
+
+  // Commands started since setup()
+  uint32_t getExecuted() const;
+
+private:
+  void cmdMove(const Cmd &cmd);
+  void cmdDwell(const Cmd &cmd);
+  void setStepperEnable(bool en);
+  void cmdStepperOn();
+  void cmdStepperOff();
+  void handleAsErr(const Cmd &cmd);
+  void fireSyncEvent(uint8_t action);
+  void cmdSegment(const Cmd &cmd);
+  void startJointMove(int32_t higher, int32_t lower, int32_t rotate, float seconds, bool settle);
+  void updateRapid();
+  void finishRapid();
+  bool jointsOnPosition();
+  void cmdTeach(const Cmd &cmd);
+  void cmdStation(const Cmd &cmd);
+  void saveStation();
+  bool plannedStation(uint8_t index, float &x, float &y, float &z);
+  void cmdSetPosition(const Cmd &cmd);
+  void reportStatus();
+  void sendTelemetry(uint32_t now);
+  void cmdTelemetry(const Cmd &cmd);
+  void cmdGripper(const Cmd &cmd, bool on);
+  void setFeedOverride(int percent);
+  void applyFeedScale();
+  void cmdFeedOverride(const Cmd &cmd);
+  void abortMotion();
+  void handleRealtime();
+  void cmdDiagnostics(const Cmd &cmd);
+  void cmdSetBaud(const Cmd &cmd);
+  void cmdRecordStart();
+  void cmdRecordStop();
+  void recordCommand(const Cmd &cmd);
+  void cmdPlay(const Cmd &cmd);
+  void cmdStopPlay();
+  void homeSequence();
+  void finishHoming();
+  void queueCommand(const Cmd &cmd);
+  void executeCommand(Cmd cmd);
+
+  RampsStepper &stepperHigher;
+  RampsStepper &stepperLower;
+  RampsStepper &stepperRotate;
+  Servo_Gripper &servo_gripper;
+  Equipment &led;
+  SerialTx &tx;
+
+  RobotGeometry geometry;
+  Interpolation interpolator;
+  Queue<Cmd, QUEUE_SIZE> queue;
+  Command command;
+  ProgramStore programStore;
+  Telemetry telemetry;
+  SyncEvents syncEvents;
+  Logger logger;
+  CpuBudget cpu;
+  Homing homing;
+
+  bool motionActive;
+  MoveClass moveClass;
+  uint32_t executed;
+
+  // joint-space move (G6 segment, M701 station) in progress
+  bool segmentActive;
+  bool segmentSettle; // also wait for the joints to arrive
+  uint32_t segmentStart;
+  uint32_t segmentDuration; // us
+
+  // G0 lift/drop on the rotate joint's own ramp, runs as a settling segment
+  bool rapidActive;
+  int32_t rapidTarget; // rotate steps
+  Point rapidEnd;
+
+  int8_t teachPending; // M700 slot waiting for the joints to arrive, -1 none
+
+  int feedOverride; // percent
+
+  // where the last queued move ends, for the soft limit checks
+  float plannedX, plannedY, plannedZ;
+};
@@ -4,17 +4,19 @@ class RobotGeometry
 {
 public:
   RobotGeometry();
-  void set(float axmm, float aymm, float azmm);
+  bool set(float axmm, float aymm, float azmm); // false: clamped to the workspace
   float getXmm() const;
   float getYmm() const;
   float getZmm() const;
   float getRotRad() const;
   float getLowRad() const;
   float getHighRad() const;
-  static bool elbow;
+  bool getElbow() const;
+  void setElbow(bool aelbow); // branch for the next solution, e.g. after a joint-space move
 
 private:
-  void calculateGrad();
+  bool calculateGrad();
+  bool elbow;
   float xmm;
   float ymm;
   float zmm;
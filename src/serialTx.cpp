@@ -0,0 +1,84 @@
+#include "serialTx.h"
+
+SerialTx::SerialTx(HardwareSerial &aport)
+    : port(aport), start(0), count(0), overflow(0), baud(BAUD)
+{
+}
+
+void SerialTx::begin(unsigned long abaud)
+{
+  baud = abaud;
+  port.begin(baud);
+}
+
+// Drains everything still pending at the old rate before switching,
+// so the reply to the baud change arrives intact.
+void SerialTx::setBaud(unsigned long abaud)
+{
+  flush();
+  port.end();
+  begin(abaud);
+}
+
+// Moves as many bytes as the hardware buffer can take without blocking.
+void SerialTx::update()
+{
+  int room = port.availableForWrite();
+  while (room > 0 && count > 0)
+  {
+    port.write(data[start]);
+    start = (start + 1) % TX_BUFFER_SIZE;
+    count--;
+    room--;
+  }
+}
+
+// Blocking drain, only for places where stalling is acceptable (baud change).
+void SerialTx::flush()
+{
+  while (count > 0)
+  {
+    port.write(data[start]);
+    start = (start + 1) % TX_BUFFER_SIZE;
+    count--;
+  }
+  port.flush();
+}
+
+size_t SerialTx::write(uint8_t c)
+{
+  if (count >= TX_BUFFER_SIZE)
+  {
+    overflow++;
+    return 0;
+  }
+  data[(start + count++) % TX_BUFFER_SIZE] = c;
+  return 1;
+}
+
+size_t SerialTx::write(const uint8_t *buf, size_t n)
+{
+  size_t room = TX_BUFFER_SIZE - count;
+  size_t len = (n < room) ? n : room;
+  for (size_t i = 0; i < len; i++)
+  {
+    data[(start + count++) % TX_BUFFER_SIZE] = buf[i];
+  }
+  overflow += n - len;
+  return len;
+}
+
+int SerialTx::availableForWrite() const
+{
+  return TX_BUFFER_SIZE - count;
+}
+
+uint32_t SerialTx::getOverflowCount() const
+{
+  return overflow;
+}
+
+unsigned long SerialTx::getBaud() const
+{
+  return baud;
+}
@@ -0,0 +1,33 @@
+#pragma once
+#include <Arduino.h>
+#include "config.h"
+
+// Non-blocking transmit path for everything the firmware prints.
+// Output is queued in a RAM ring buffer and handed to the UART's own
+// interrupt-driven buffer from loop() only as far as it has room, so a
+// print never stalls the steppers. Bytes that don't fit are dropped and counted.
+class SerialTx : public Print
+{
+public:
+  SerialTx(HardwareSerial &port);
+  void begin(unsigned long baud);
+  void setBaud(unsigned long baud);
+  void update();
+  void flush();
+
+  size_t write(uint8_t c) override;
+  size_t write(const uint8_t *buf, size_t n) override;
+  using Print::write;
+
+  int availableForWrite() const;
+  uint32_t getOverflowCount() const;
+  unsigned long getBaud() const;
+
+private:
+  HardwareSerial &port;
+  uint8_t data[TX_BUFFER_SIZE];
+  uint16_t start;
+  uint16_t count;
+  uint32_t overflow; // dropped bytes
+  unsigned long baud;
+};
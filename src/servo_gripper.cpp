@@ -3,8 +3,9 @@
 #include "servo_gripper.h"
 #include <Arduino.h>
 #include <Servo.h>
+#include "config.h"
 
-Servo_Gripper::Servo_Gripper(int pin, float grip_degree, float ungrip_degree) : servo_motor()
+Servo_Gripper::Servo_Gripper(int pin, float grip_degree, float ungrip_degree) : servo_motor(), detach_at(0)
 {
   servo_pin = pin;
   servo_grip_deg = grip_degree;
@@ -15,7 +16,7 @@ void Servo_Gripper::cmdOn()
 {
   servo_motor.attach(servo_pin);
   servo_motor.write(servo_grip_deg);
-  delay(300);
+  delay(SERVO_MOVE_MS);
   servo_motor.detach();
 }
 
@@ -23,6 +24,35 @@ void Servo_Gripper::cmdOff()
 {
   servo_motor.attach(servo_pin);
   servo_motor.write(servo_ungrip_deg);
-  delay(300);
+  delay(SERVO_MOVE_MS);
   servo_motor.detach();
 }
+
+void Servo_Gripper::startOn()
+{
+  start(servo_grip_deg);
+}
+
+void Servo_Gripper::startOff()
+{
+  start(servo_ungrip_deg);
+}
+
+void Servo_Gripper::start(float degree)
+{
+  servo_motor.attach(servo_pin);
+  servo_motor.write(degree);
+  detach_at = millis() + SERVO_MOVE_MS;
+  if (detach_at == 0)
+    detach_at = 1;
+}
+
+// Detaches once the servo had its time to move, like the blocking commands.
+void Servo_Gripper::update()
+{
+  if (detach_at != 0 && (long)(millis() - detach_at) >= 0)
+  {
+    servo_motor.detach();
+    detach_at = 0;
+  }
+}
@@ -9,8 +9,15 @@ public:
   void cmdOn();
   void cmdOff();
 
+  // Non-blocking versions for use during motion; update() finishes them.
+  void startOn();
+  void startOff();
+  void update();
+
 private:
+  void start(float degree);
   Servo servo_motor;
+  unsigned long detach_at; // millis(), 0 = nothing pending
   int servo_pin;
   float servo_grip_deg;
   float servo_ungrip_deg;
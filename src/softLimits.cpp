@@ -0,0 +1,107 @@
+#include "softLimits.h"
+
+uint8_t SoftLimits::checkPoint(float x, float y, float z)
+{
+  if (z < Z_MIN || z > Z_MAX)
+    return LIMIT_Z;
+  float rSq = x * x + y * y;
+  if (rSq > JointLimits::rMaxSq)
+    return LIMIT_REACH;
+  if (rSq < JointLimits::rMinSq)
+    return LIMIT_BASE;
+  return checkJoints(x, y, z);
+}
+
+uint8_t SoftLimits::checkMove(float x0, float y0, float z0, float x1, float y1, float z1)
+{
+  uint8_t error = checkPoint(x1, y1, z1);
+  if (error != LIMIT_OK)
+    return error;
+
+  // closest approach of the XY path to the base axis, z is linear anyway
+  float dx = x1 - x0;
+  float dy = y1 - y0;
+  float lenSq = dx * dx + dy * dy;
+  if (lenSq <= 0.0f)
+    return LIMIT_OK; // pure Z: the plane joints don't move
+  float t = -(x0 * dx + y0 * dy) / lenSq;
+  if (t > 0.0f && t < 1.0f)
+  {
+    float cx = x0 + t * dx;
+    float cy = y0 + t * dy;
+    if (cx * cx + cy * cy < JointLimits::rMinSq)
+      return LIMIT_BASE;
+    error = checkJoints(cx, cy, z0 + t * (z1 - z0));
+    if (error != LIMIT_OK)
+      return error;
+  }
+
+  // The elbow swings over where the path crosses x = 0. The joints turn
+  // straight from one branch to the other there, so both have to be in.
+  if ((x0 < 0.0f) != (x1 < 0.0f) && x0 != 0.0f && x1 != 0.0f)
+  {
+    float u = x0 / (x0 - x1);
+    float cy = y0 + u * dy;
+    float cz = z0 + u * (z1 - z0);
+    error = checkJoints(0.0f, cy, cz, false);
+    if (error == LIMIT_OK)
+      error = checkJoints(0.0f, cy, cz, true);
+    if (error != LIMIT_OK)
+      return error;
+  }
+
+  // the ends are done, sample in between
+  int n = (int)ceilf(sqrtf(lenSq) / LIMIT_SAMPLE_MM);
+  if (n > LIMIT_SAMPLES_MAX)
+    n = LIMIT_SAMPLES_MAX;
+  for (int i = 1; i < n; i++)
+  {
+    float u = (float)i / n;
+    error = checkJoints(x0 + u * dx, y0 + u * dy, z0 + u * (z1 - z0));
+    if (error != LIMIT_OK)
+      return error;
+  }
+  return LIMIT_OK;
+}
+
+// A joint-space target (G6) as given, on whatever branch its angles are.
+// Hands back the Cartesian point it lands on for the next move's check.
+uint8_t SoftLimits::checkJointPoint(float rot, float low, float high, float &x, float &y, float &z)
+{
+  if (low < JointLimits::lowMin || low > JointLimits::lowMax ||
+      high < JointLimits::highMin || high > JointLimits::highMax)
+    return LIMIT_JOINT;
+  Kinematics::forward(rot, low, high, x, y, z);
+  if (z < Z_MIN || z > Z_MAX)
+    return LIMIT_Z;
+  if (x * x + y * y < JointLimits::rMinSq)
+    return LIMIT_BASE;
+  return LIMIT_OK;
+}
+
+// inverse() picks the branch from x, elbow only counts on x = 0
+uint8_t SoftLimits::checkJoints(float x, float y, float z, bool elbow)
+{
+  float rot, low, high;
+  Kinematics::inverse(x, y, z, elbow, rot, low, high);
+  if (low < JointLimits::lowMin || low > JointLimits::lowMax ||
+      high < JointLimits::highMin || high > JointLimits::highMax)
+    return LIMIT_JOINT;
+  return LIMIT_OK;
+}
+
+const char *SoftLimits::describe(uint8_t error)
+{
+  switch (error)
+  {
+  case LIMIT_Z:
+    return "Z out of range";
+  case LIMIT_REACH:
+    return "out of reach";
+  case LIMIT_BASE:
+    return "too close to the base";
+  case LIMIT_JOINT:
+    return "joint limit";
+  }
+  return "ok";
+}
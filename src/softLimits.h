@@ -0,0 +1,44 @@
+#pragma once
+#include "kinematics.h"
+
+#define LIMIT_OK 0
+#define LIMIT_Z 1     // outside Z_MIN..Z_MAX
+#define LIMIT_REACH 2 // beyond L1 + L2
+#define LIMIT_BASE 3  // inside R_MIN, or the path passes through it
+#define LIMIT_JOINT 4 // a joint would pass its stop
+
+#define LIMIT_SAMPLE_MM 20.0f // joint stops are checked this far apart along a move
+#define LIMIT_SAMPLES_MAX 16  // at most this many points per move, long ones get sparser
+
+// Joint stops from config.h, in radians, folded at compile time
+struct JointLimits
+{
+  static constexpr float lowMin = (float)(LOW_MIN_DEG * PI / 180.0);
+  static constexpr float lowMax = (float)(LOW_MAX_DEG * PI / 180.0);
+  static constexpr float highMin = (float)(HIGH_MIN_DEG * PI / 180.0);
+  static constexpr float highMax = (float)(HIGH_MAX_DEG * PI / 180.0);
+  static constexpr float rMinSq = (float)(R_MIN * R_MIN);
+  static constexpr float rMaxSq = Kinematics::maxReach * Kinematics::maxReach * 1.0001f;
+};
+
+// Validates moves once, before they are queued, so motion never has to
+// clamp. The reachable area is an annulus: a straight move between two
+// points inside it stays inside the outer circle, but can cut through the
+// keep-out around the base, so that one is checked at the path's closest
+// approach. inverse() takes the elbow branch from the sign of x, so a move
+// from one side of x = 0 to the other swings the arm over where it crosses;
+// the stops are checked on both branches there. Joint angles don't peak at a point that is easy to name,
+// so the stops are checked at the ends, the closest approach and samples
+// along the path; between samples a joint can pass a stop by what it
+// turns over LIMIT_SAMPLE_MM of travel.
+class SoftLimits
+{
+public:
+  static uint8_t checkPoint(float x, float y, float z);
+  static uint8_t checkMove(float x0, float y0, float z0, float x1, float y1, float z1);
+  static uint8_t checkJointPoint(float rot, float low, float high, float &x, float &y, float &z);
+  static const char *describe(uint8_t error);
+
+private:
+  static uint8_t checkJoints(float x, float y, float z, bool elbow = false);
+};
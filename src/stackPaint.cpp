@@ -0,0 +1,58 @@
+#include "stackPaint.h"
+#include "config.h"
+
+#ifdef ARDUINO_ARCH_AVR
+#include <avr/io.h>
+
+extern uint8_t _end;    // end of .bss, where a heap would start
+extern uint8_t __stack; // top of RAM
+
+// Runs from the startup code, after the stack pointer is set and before
+// any constructor, so nothing is in use yet but the return-free .init3.
+void paintStack() __attribute__((naked, used, section(".init3")));
+void paintStack()
+{
+  for (uint8_t *p = &_end; p <= &__stack; p++)
+  {
+    *p = STACK_PAINT;
+  }
+}
+
+uint16_t StackPaint::staticBytes()
+{
+  return (uint16_t)(&_end - (uint8_t *)RAMSTART);
+}
+
+uint16_t StackPaint::freeBytes()
+{
+  const uint8_t *p = &_end;
+  while (p <= &__stack && *p == STACK_PAINT)
+  {
+    p++;
+  }
+  return (uint16_t)(p - &_end);
+}
+
+uint16_t StackPaint::peakBytes()
+{
+  return (uint16_t)(&__stack - &_end + 1) - freeBytes();
+}
+
+#else
+
+uint16_t StackPaint::staticBytes()
+{
+  return 0;
+}
+
+uint16_t StackPaint::peakBytes()
+{
+  return 0;
+}
+
+uint16_t StackPaint::freeBytes()
+{
+  return 0;
+}
+
+#endif
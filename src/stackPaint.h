@@ -0,0 +1,15 @@
+#pragma once
+#include <stdint.h>
+
+// RAM use as measured, not estimated. On the Mega every byte between the
+// end of the static data and the top of the stack is painted with
+// STACK_PAINT before main() runs (there is no heap); the bytes the stack
+// never reached still hold it. The native build has nothing to measure
+// and reports zeros.
+class StackPaint
+{
+public:
+  static uint16_t staticBytes(); // .data + .bss
+  static uint16_t peakBytes();   // deepest the stack has been
+  static uint16_t freeBytes();   // never touched, the real headroom
+};
@@ -0,0 +1,35 @@
+#include "storage.h"
+#include <EEPROM.h>
+
+uint8_t Storage::read(uint16_t addr)
+{
+  return EEPROM.read(addr);
+}
+
+void Storage::write(uint16_t addr, uint8_t value)
+{
+  EEPROM.update(addr, value); // skips the erase/write cycle if unchanged
+}
+
+uint16_t Storage::size()
+{
+  return EEPROM.length();
+}
+
+void Storage::read(uint16_t addr, void *buf, uint16_t n)
+{
+  uint8_t *p = (uint8_t *)buf;
+  for (uint16_t i = 0; i < n; i++)
+  {
+    p[i] = read(addr + i);
+  }
+}
+
+void Storage::write(uint16_t addr, const void *buf, uint16_t n)
+{
+  const uint8_t *p = (const uint8_t *)buf;
+  for (uint16_t i = 0; i < n; i++)
+  {
+    write(addr + i, p[i]);
+  }
+}
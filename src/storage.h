@@ -0,0 +1,14 @@
+#pragma once
+#include <stdint.h>
+
+// Byte-addressed non-volatile storage in the Mega's internal EEPROM. Host
+// builds get the EEPROM library from tools/host, see EEPROM.h there.
+class Storage
+{
+public:
+  static uint8_t read(uint16_t addr);
+  static void write(uint16_t addr, uint8_t value);
+  static void read(uint16_t addr, void *buf, uint16_t n);
+  static void write(uint16_t addr, const void *buf, uint16_t n);
+  static uint16_t size();
+};
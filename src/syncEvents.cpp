@@ -0,0 +1,77 @@
+#include "syncEvents.h"
+
+SyncEvents::SyncEvents()
+    : count(0)
+{
+}
+
+// Queues an event for the next move. False if all slots are taken.
+bool SyncEvents::arm(uint8_t action, uint8_t trigger, float value)
+{
+  if (count >= SYNC_EVENT_MAX)
+    return false;
+  SyncEvent &e = events[count++];
+  e.action = action;
+  e.trigger = trigger;
+  e.active = false;
+  e.value = value;
+  return true;
+}
+
+// A move just started: everything armed so far belongs to it.
+void SyncEvents::startMove()
+{
+  for (uint8_t i = 0; i < count; i++)
+  {
+    events[i].active = true;
+  }
+}
+
+// Hands out one event of the running move that is due, if any.
+bool SyncEvents::poll(float progress, float remaining, uint8_t &action)
+{
+  for (uint8_t i = 0; i < count; i++)
+  {
+    const SyncEvent &e = events[i];
+    if (!e.active)
+      continue;
+    bool due = (e.trigger == SYNC_AT_PROGRESS) ? (progress >= e.value) : (remaining <= e.value);
+    if (due)
+    {
+      action = e.action;
+      remove(i);
+      return true;
+    }
+  }
+  return false;
+}
+
+// The move ended: hands out whatever of it has not fired yet.
+bool SyncEvents::finishMove(uint8_t &action)
+{
+  for (uint8_t i = 0; i < count; i++)
+  {
+    if (events[i].active)
+    {
+      action = events[i].action;
+      remove(i);
+      return true;
+    }
+  }
+  return false;
+}
+
+void SyncEvents::clear()
+{
+  count = 0;
+}
+
+// keeps arming order
+void SyncEvents::remove(uint8_t i)
+{
+  for (; i + 1 < count; i++)
+  {
+    events[i] = events[i + 1];
+  }
+  count--;
+}
@@ -0,0 +1,43 @@
+#pragma once
+#include <stdint.h>
+#include "config.h"
+
+// Outputs that can be tied to a point in a move
+enum SyncAction
+{
+  SYNC_GRIPPER_ON,
+  SYNC_GRIPPER_OFF
+};
+
+enum SyncTrigger
+{
+  SYNC_AT_PROGRESS, // value: fraction of the path, 0..1
+  SYNC_BEFORE_END   // value: seconds before the move ends
+};
+
+struct SyncEvent
+{
+  uint8_t action;
+  uint8_t trigger;
+  bool active; // belongs to the running move, else waits for the next one
+  float value;
+};
+
+// Output events armed by M3/M5 S<percent> or T<seconds> and fired by the
+// motion loop while the following move runs, so actuation overlaps motion.
+class SyncEvents
+{
+public:
+  SyncEvents();
+  bool arm(uint8_t action, uint8_t trigger, float value);
+  void startMove();
+  bool poll(float progress, float remaining, uint8_t &action);
+  bool finishMove(uint8_t &action);
+  void clear();
+  bool isArmed() const { return count > 0; }
+
+private:
+  void remove(uint8_t i);
+  SyncEvent events[SYNC_EVENT_MAX];
+  uint8_t count;
+};
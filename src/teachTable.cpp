@@ -0,0 +1,46 @@
+#include "teachTable.h"
+#include "storage.h"
+#include "config.h"
+
+static_assert(TEACH_START + TEACH_POINTS * sizeof(TeachPoint) <= STORAGE_SIZE,
+              "teach table does not fit the EEPROM");
+
+bool TeachTable::save(uint8_t index, float x, float y, float z,
+                      int32_t higher, int32_t lower, int32_t rotate, bool elbow)
+{
+  if (index >= TEACH_POINTS)
+    return false;
+  TeachPoint point;
+  point.tag = TEACH_TAG | (elbow ? 1 : 0);
+  point.x = x;
+  point.y = y;
+  point.z = z;
+  point.higher = higher;
+  point.lower = lower;
+  point.rotate = rotate;
+  Storage::write(TEACH_START + index * sizeof(TeachPoint), &point, sizeof(point));
+  return true;
+}
+
+// False for an index out of range or a slot never taught
+bool TeachTable::load(uint8_t index, TeachPoint &point)
+{
+  if (index >= TEACH_POINTS)
+    return false;
+  Storage::read(TEACH_START + index * sizeof(TeachPoint), &point, sizeof(point));
+  return (point.tag & 0xFE) == TEACH_TAG;
+}
+
+bool TeachTable::elbow(const TeachPoint &point)
+{
+  return point.tag & 1;
+}
+
+// Checked on the float, before the cast could wrap it into range
+bool TeachTable::slot(float s, uint8_t &index)
+{
+  if (!(s >= 0 && s < TEACH_POINTS)) // NaN fails too
+    return false;
+  index = (uint8_t)s;
+  return true;
+}
@@ -0,0 +1,25 @@
+#pragma once
+#include <stdint.h>
+
+// One taught station: the Cartesian pose plus the joint steps and elbow
+// branch it was solved to, so returning there needs no IK.
+struct __attribute__((packed)) TeachPoint
+{
+  uint8_t tag; // TEACH_TAG, bit 0 = elbow; anything else is an empty slot
+  float x, y, z;
+  int32_t higher, lower, rotate;
+};
+
+#define TEACH_TAG 0xC0
+
+// Station table in non-volatile memory at TEACH_START, TEACH_POINTS slots.
+class TeachTable
+{
+public:
+  static bool save(uint8_t index, float x, float y, float z,
+                   int32_t higher, int32_t lower, int32_t rotate, bool elbow);
+  static bool load(uint8_t index, TeachPoint &point);
+  static bool elbow(const TeachPoint &point);
+  // S word to a slot index, false when missing or outside the table
+  static bool slot(float s, uint8_t &index);
+};
@@ -0,0 +1,81 @@
+#include <Arduino.h>
+#include "telemetry.h"
+#include "config.h"
+
+Telemetry::Telemetry(SerialTx &atx)
+    : tx(atx), intervalUs(0), lastFrameUs(0),
+      loopSumUs(0), loopCount(0), loopMaxUs(0), dropped(0)
+{
+}
+
+// hz <= 0 turns the stream off
+void Telemetry::setRate(float hz)
+{
+  if (hz > TELEMETRY_MAX_HZ)
+    hz = TELEMETRY_MAX_HZ;
+  intervalUs = (hz > 0) ? (uint32_t)(1e6f / hz) : 0;
+  lastFrameUs = micros();
+  // the first frame covers the passes since now, not since the last stream
+  loopSumUs = 0;
+  loopCount = 0;
+  loopMaxUs = 0;
+}
+
+void Telemetry::tick(uint16_t periodUs)
+{
+  if (periodUs > loopMaxUs)
+    loopMaxUs = periodUs;
+  loopSumUs += periodUs;
+  loopCount++;
+}
+
+bool Telemetry::due(uint32_t nowUs) const
+{
+  return intervalUs != 0 && (uint32_t)(nowUs - lastFrameUs) >= intervalUs;
+}
+
+// Fills in framing and loop stats, then queues the frame whole or not at all.
+bool Telemetry::send(TelemetryFrame &frame)
+{
+  lastFrameUs = frame.timeUs;
+
+  frame.sync[0] = TELEMETRY_SYNC0;
+  frame.sync[1] = TELEMETRY_SYNC1;
+  frame.length = TELEMETRY_PAYLOAD;
+  frame.loopMaxUs = getLoopMaxUs();
+  frame.loopAvgUs = getLoopAvgUs();
+  loopSumUs = 0;
+  loopCount = 0;
+  loopMaxUs = 0;
+
+  const uint8_t *payload = (const uint8_t *)&frame.timeUs;
+  uint8_t sum = 0;
+  for (uint8_t i = 0; i < TELEMETRY_PAYLOAD; i++)
+  {
+    sum ^= payload[i];
+  }
+  frame.checksum = sum;
+
+  if (tx.availableForWrite() < (int)sizeof(frame))
+  {
+    dropped++;
+    return false;
+  }
+  tx.write((const uint8_t *)&frame, sizeof(frame));
+  return true;
+}
+
+uint16_t Telemetry::getLoopMaxUs() const
+{
+  return loopMaxUs;
+}
+
+uint16_t Telemetry::getLoopAvgUs() const
+{
+  return loopCount ? loopSumUs / loopCount : 0;
+}
+
+uint32_t Telemetry::getDropped() const
+{
+  return dropped;
+}
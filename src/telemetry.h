@@ -0,0 +1,51 @@
+#pragma once
+#include <stdint.h>
+#include "serialTx.h"
+
+#define TELEMETRY_SYNC0 0xA5
+#define TELEMETRY_SYNC1 0x5A
+
+// One binary telemetry frame, little-endian as on both the Mega and x86.
+// The checksum is the XOR of all payload bytes (everything after length).
+struct __attribute__((packed)) TelemetryFrame
+{
+  uint8_t sync[2];
+  uint8_t length;         // payload bytes
+  uint32_t timeUs;        // micros() when packed
+  int32_t higher;         // joint steps
+  int32_t lower;
+  int32_t rotate;
+  float xmm, ymm, zmm;    // interpolated position
+  uint8_t queue;          // commands waiting
+  uint16_t loopMaxUs;     // longest loop() pass since the last frame
+  uint16_t loopAvgUs;     // mean loop() pass since the last frame
+  uint8_t checksum;
+};
+
+#define TELEMETRY_PAYLOAD (sizeof(TelemetryFrame) - 4)
+
+// Fixed-rate telemetry stream plus the loop timing it reports.
+// tick() takes every loop pass's period as CpuBudget measured it; due()
+// says when a frame should go out.
+class Telemetry
+{
+public:
+  Telemetry(SerialTx &tx);
+  void setRate(float hz);
+  void tick(uint16_t periodUs);
+  bool due(uint32_t nowUs) const;
+  bool send(TelemetryFrame &frame);
+
+  uint16_t getLoopMaxUs() const;
+  uint16_t getLoopAvgUs() const;
+  uint32_t getDropped() const;
+
+private:
+  SerialTx &tx;
+  uint32_t intervalUs; // 0 = off
+  uint32_t lastFrameUs;
+  uint32_t loopSumUs;
+  uint32_t loopCount; // passes between slow frames outrun 16 bits
+  uint16_t loopMaxUs;
+  uint32_t dropped;
+};
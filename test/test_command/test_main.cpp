@@ -0,0 +1,186 @@
+#include <unity.h>
+#include <Arduino.h>
+#include <string.h>
+#include "command.h"
+
+// Serial input from a buffer, replies collected in another
+class BufferStream : public Stream
+{
+public:
+  BufferStream(const char *in, size_t n) : input(in), size(n), pos(0), length(0) { output[0] = 0; }
+  BufferStream(const char *in) : BufferStream(in, strlen(in)) {}
+  int available() override { return size - pos; }
+  int read() override { return (pos < size) ? (uint8_t)input[pos++] : -1; }
+  int peek() override { return (pos < size) ? (uint8_t)input[pos] : -1; }
+  size_t write(uint8_t c) override
+  {
+    if (length + 1 < sizeof(output))
+    {
+      output[length++] = c;
+      output[length] = 0;
+    }
+    return 1;
+  }
+  using Print::write;
+
+  const char *input;
+  size_t size;
+  size_t pos;
+  char output[64];
+  size_t length;
+};
+
+void setUp() {}
+void tearDown() {}
+
+static void test_move_words()
+{
+  Command command;
+  TEST_ASSERT_TRUE(command.processMessage("G1 X10 Y-5.5 Z3 F3000"));
+  Cmd cmd = command.getCmd();
+  TEST_ASSERT_EQUAL_CHAR('G', cmd.id);
+  TEST_ASSERT_EQUAL_INT(1, cmd.num);
+  TEST_ASSERT_EQUAL_FLOAT(10, cmd.valueX);
+  TEST_ASSERT_EQUAL_FLOAT(-5.5f, cmd.valueY);
+  TEST_ASSERT_EQUAL_FLOAT(3, cmd.valueZ);
+  TEST_ASSERT_EQUAL_FLOAT(3000, cmd.valueF);
+}
+
+// what isn't given: NAN for the axes and S, 0 for F and T
+static void test_defaults()
+{
+  Command command;
+  TEST_ASSERT_TRUE(command.processMessage("G28"));
+  Cmd cmd = command.getCmd();
+  TEST_ASSERT_EQUAL_INT(28, cmd.num);
+  TEST_ASSERT_FLOAT_IS_NAN(cmd.valueX);
+  TEST_ASSERT_FLOAT_IS_NAN(cmd.valueY);
+  TEST_ASSERT_FLOAT_IS_NAN(cmd.valueZ);
+  TEST_ASSERT_FLOAT_IS_NAN(cmd.valueS);
+  TEST_ASSERT_EQUAL_FLOAT(0, cmd.valueF);
+  TEST_ASSERT_EQUAL_FLOAT(0, cmd.valueT);
+}
+
+static void test_aliases()
+{
+  Command command;
+  TEST_ASSERT_TRUE(command.processMessage("M575 B115200"));
+  TEST_ASSERT_EQUAL_FLOAT(115200, command.getCmd().valueS);
+  TEST_ASSERT_TRUE(command.processMessage("G1 E20"));
+  TEST_ASSERT_EQUAL_FLOAT(20, command.getCmd().valueZ);
+}
+
+static void test_not_gcode()
+{
+  BufferStream port("");
+  Command command(&port);
+  TEST_ASSERT_FALSE(command.processMessage("X10"));
+  TEST_ASSERT_TRUE(strstr(port.output, "rs") != NULL);
+}
+
+static void test_lines_from_stream()
+{
+  BufferStream port("G1 X1\r\nM3 S50 T0.5\r\n");
+  Command command(&port, &port);
+  TEST_ASSERT_TRUE(command.handleGcode());
+  TEST_ASSERT_EQUAL_FLOAT(1, command.getCmd().valueX);
+  TEST_ASSERT_TRUE(command.handleGcode());
+  Cmd cmd = command.getCmd();
+  TEST_ASSERT_EQUAL_CHAR('M', cmd.id);
+  TEST_ASSERT_EQUAL_FLOAT(50, cmd.valueS);
+  TEST_ASSERT_EQUAL_FLOAT(0.5f, cmd.valueT);
+  TEST_ASSERT_FALSE(command.handleGcode());
+}
+
+// a line past LINE_BUFFER_SIZE is refused whole, the next one is fine
+static void test_overlong_line()
+{
+  char input[LINE_BUFFER_SIZE + 32] = "G1 X1";
+  while (strlen(input) < LINE_BUFFER_SIZE + 10)
+    strcat(input, " F1");
+  strcat(input, "\r\nG1 X7\r\n");
+  BufferStream port(input);
+  Command command(&port, &port);
+  bool parsed = false;
+  for (int i = 0; i < 4 && !parsed; i++)
+    parsed = command.handleGcode();
+  TEST_ASSERT_TRUE(parsed);
+  TEST_ASSERT_EQUAL_FLOAT(7, command.getCmd().valueX);
+  TEST_ASSERT_TRUE(strstr(port.output, "rs") != NULL);
+}
+
+// taken out of the stream wherever they arrive, even inside a line
+static void test_realtime_bytes()
+{
+  const char input[] = "G1 ?X!5~\r\n\x18\x90\x91\x91\x94";
+  BufferStream port(input, sizeof(input) - 1);
+  Command command(&port, &port);
+  TEST_ASSERT_TRUE(command.handleGcode());
+  TEST_ASSERT_EQUAL_FLOAT(5, command.getCmd().valueX);
+  uint16_t rt = command.getRealtime();
+  TEST_ASSERT_EQUAL_INT(RT_STATUS_REPORT | RT_FEED_HOLD | RT_CYCLE_START | RT_ABORT |
+                            RT_OVR_RESET | RT_OVR_STEP,
+                        rt);
+  TEST_ASSERT_EQUAL_INT(19, command.takeOverrideSteps()); // repeats count
+  TEST_ASSERT_FALSE(command.getRealtime() & RT_OVR_STEP);
+  command.clearRealtime(rt);
+  TEST_ASSERT_EQUAL_INT(0, command.getRealtime());
+}
+
+// Real-time bytes get through a full buffer. The G-code that didn't fit is
+// dropped to the end of its line, which is answered with an error.
+static void test_full_buffer()
+{
+  char input[RX_BUFFER_SIZE + 16] = "";
+  int lines = 0;
+  while (strlen(input) + 7 < RX_BUFFER_SIZE)
+  {
+    strcat(input, "G1 X1\r\n");
+    lines++;
+  }
+  strcat(input, "G1 X2\r\n!");
+  BufferStream port(input);
+  Command command(&port, &port);
+  command.receive();
+  TEST_ASSERT_EQUAL_INT(0, port.available());
+  TEST_ASSERT_TRUE(command.getRealtime() & RT_FEED_HOLD);
+  TEST_ASSERT_EQUAL_INT(0, command.getRxFree());
+  for (int i = 0; i < lines; i++)
+  {
+    TEST_ASSERT_TRUE(command.handleGcode());
+    TEST_ASSERT_EQUAL_FLOAT(1, command.getCmd().valueX);
+  }
+  TEST_ASSERT_FALSE(command.handleGcode());
+  TEST_ASSERT_TRUE(strstr(port.output, "rs") != NULL);
+  TEST_ASSERT_TRUE(command.isRxEmpty());
+  TEST_ASSERT_EQUAL_INT(RX_BUFFER_SIZE - 1, command.getRxFree());
+}
+
+int runTests()
+{
+  UNITY_BEGIN();
+  RUN_TEST(test_move_words);
+  RUN_TEST(test_defaults);
+  RUN_TEST(test_aliases);
+  RUN_TEST(test_not_gcode);
+  RUN_TEST(test_lines_from_stream);
+  RUN_TEST(test_overlong_line);
+  RUN_TEST(test_realtime_bytes);
+  RUN_TEST(test_full_buffer);
+  return UNITY_END();
+}
+
+#ifdef ARDUINO
+void setup()
+{
+  delay(2000); // the board resets when the test runner opens the port
+  runTests();
+}
+
+void loop() {}
+#else
+int main(int argc, char **argv)
+{
+  return runTests();
+}
+#endif
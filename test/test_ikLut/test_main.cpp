@@ -0,0 +1,94 @@
+#include <unity.h>
+
+// This test only: build the table backend next to the exact one. The
+// tables are compiled here too, src/ikLut.cpp is empty without the switch.
+#define KINEMATICS_LUT
+#include "kinematics.h"
+#include "ikLut.cpp"
+
+typedef ScaraKinematics<ScaraParams> Exact;
+typedef LutKinematics<ScaraParams> Lut;
+
+// tools/lutGen sizes the tables for a quarter step of the finest joint
+// against double precision; the float exact solver adds a little of its own
+static const float maxErrRad = 0.25f / JointDrive::higherStepsPerRad + 2e-6f;
+
+void setUp() {}
+void tearDown() {}
+
+static float worst = 0;
+
+static void compare(float x, float y, float z)
+{
+  bool e0 = false, e1 = false;
+  float rot0, low0, high0, rot1, low1, high1;
+  Exact::inverse(x, y, z, e0, rot0, low0, high0);
+  Lut::inverse(x, y, z, e1, rot1, low1, high1);
+  TEST_ASSERT_EQUAL(e0, e1);
+  TEST_ASSERT_FLOAT_WITHIN(1e-6f, rot0, rot1);
+  TEST_ASSERT_FLOAT_WITHIN(maxErrRad, low0, low1);
+  TEST_ASSERT_FLOAT_WITHIN(maxErrRad, high0, high1);
+  worst = fmaxf(worst, fmaxf(fabsf(low0 - low1), fabsf(high0 - high1)));
+}
+
+// the whole tabulated annulus, all four quadrants, both elbow branches
+static void test_annulus()
+{
+  for (float r = R_MIN; r * r < IK_LUT_R2_MAX; r += 0.73f)
+  {
+    for (float a = -180; a < 180; a += 1.7f)
+    {
+      compare(r * cosf(a * (float)PI / 180), r * sinf(a * (float)PI / 180), 50);
+    }
+  }
+  TEST_ASSERT_TRUE(worst > 0); // the tables were really used
+}
+
+// octant edges of the bearing table and the table ends
+static void test_edges()
+{
+  const float r = 200;
+  const float d = r * 0.70710678f;
+  compare(r, 0, 0);
+  compare(0.001f, r, 0);
+  compare(-r, 0.001f, 0);
+  compare(d, d, 0);
+  compare(-d, -d, 0);
+  compare(R_MIN + 0.01f, 0, 0);
+  compare(sqrtf(IK_LUT_R2_MAX) - 0.01f, 0, 0);
+}
+
+// outside the tables the exact solver answers, unchanged
+static void test_falls_back()
+{
+  bool e0 = false, e1 = false;
+  float rot0, low0, high0, rot1, low1, high1;
+  Exact::inverse(20, 10, 0, e0, rot0, low0, high0);
+  Lut::inverse(20, 10, 0, e1, rot1, low1, high1);
+  TEST_ASSERT_EQUAL_FLOAT(low0, low1);
+  TEST_ASSERT_EQUAL_FLOAT(high0, high1);
+}
+
+int runTests()
+{
+  UNITY_BEGIN();
+  RUN_TEST(test_annulus);
+  RUN_TEST(test_edges);
+  RUN_TEST(test_falls_back);
+  return UNITY_END();
+}
+
+#ifdef ARDUINO
+void setup()
+{
+  delay(2000); // the board resets when the test runner opens the port
+  runTests();
+}
+
+void loop() {}
+#else
+int main(int argc, char **argv)
+{
+  return runTests();
+}
+#endif
@@ -0,0 +1,100 @@
+#include <unity.h>
+#include "kinematics.h"
+
+// the exact solver, whichever backend config.h picks for the firmware
+typedef ScaraKinematics<ScaraParams> Exact;
+
+#define ROUND_TRIP_MM 1e-3f
+
+void setUp() {}
+void tearDown() {}
+
+// joint angles back to the tool point, straight from the arm's geometry
+static void forward(float rot, float low, float high, float &x, float &y, float &z)
+{
+  float shoulder = low + (float)(PI * 0.5);
+  float elbowDir = shoulder + (high - ScaraParams::coupling * low);
+  x = L1 * cosf(shoulder) + L2 * cosf(elbowDir);
+  y = L1 * sinf(shoulder) + L2 * sinf(elbowDir);
+  z = rot / Exact::rotPerMm;
+}
+
+// forward(inverse(p)) over the annulus on one side of x = 0, which is
+// what picks the elbow branch
+static void roundTrip(float sign, bool branch)
+{
+  for (float r = 20; r < Exact::maxReach - 1; r += 7.5f)
+  {
+    for (float a = -85; a <= 85; a += 5)
+    {
+      float x = sign * r * cosf(a * (float)PI / 180);
+      float y = r * sinf(a * (float)PI / 180);
+      float z = 120;
+      bool elbow = !branch; // inverse() must override a stale choice
+      float rot, low, high;
+      TEST_ASSERT_TRUE(Exact::inverse(x, y, z, elbow, rot, low, high));
+      TEST_ASSERT_EQUAL(branch, elbow);
+      float fx, fy, fz;
+      forward(rot, low, high, fx, fy, fz);
+      TEST_ASSERT_FLOAT_WITHIN(ROUND_TRIP_MM, x, fx);
+      TEST_ASSERT_FLOAT_WITHIN(ROUND_TRIP_MM, y, fy);
+      TEST_ASSERT_FLOAT_WITHIN(ROUND_TRIP_MM, z, fz);
+    }
+  }
+}
+
+static void test_round_trip_elbow_down()
+{
+  roundTrip(1, false);
+}
+
+static void test_round_trip_elbow_up()
+{
+  roundTrip(-1, true);
+}
+
+// the two branches mirror each other across x = 0
+static void test_branches_mirror()
+{
+  bool down = false, up = true;
+  float rot0, low0, high0, rot1, low1, high1;
+  Exact::inverse(180, 60, 0, down, rot0, low0, high0);
+  Exact::inverse(-180, 60, 0, up, rot1, low1, high1);
+  TEST_ASSERT_FLOAT_WITHIN(1e-5f, -low0, low1);
+  TEST_ASSERT_FLOAT_WITHIN(1e-5f, -high0, high1);
+}
+
+static void test_out_of_reach_clamps()
+{
+  bool elbow = false;
+  float rot, low, high;
+  TEST_ASSERT_FALSE(Exact::inverse(Exact::maxReach + 10, 0, 0, elbow, rot, low, high));
+  float x, y, z;
+  forward(rot, low, high, x, y, z);
+  TEST_ASSERT_FLOAT_WITHIN(0.01f, Exact::maxReach, x);
+}
+
+int runTests()
+{
+  UNITY_BEGIN();
+  RUN_TEST(test_round_trip_elbow_down);
+  RUN_TEST(test_round_trip_elbow_up);
+  RUN_TEST(test_branches_mirror);
+  RUN_TEST(test_out_of_reach_clamps);
+  return UNITY_END();
+}
+
+#ifdef ARDUINO
+void setup()
+{
+  delay(2000); // the board resets when the test runner opens the port
+  runTests();
+}
+
+void loop() {}
+#else
+int main(int argc, char **argv)
+{
+  return runTests();
+}
+#endif
@@ -0,0 +1,141 @@
+#include <unity.h>
+#include <Arduino.h>
+#include "config.h"
+#include "programStore.h"
+
+#ifndef ARDUINO
+static host::Eeprom *eeprom;
+
+// every test starts on an erased EEPROM of its own, not the storage file
+void setUp()
+{
+  eeprom = new host::Eeprom(STORAGE_SIZE);
+  host::bindEeprom(eeprom);
+}
+
+void tearDown()
+{
+  host::bindEeprom(NULL);
+  delete eeprom;
+}
+#else
+void setUp() {}
+void tearDown() {}
+#endif
+
+static Cmd make(char id, int num, float x, float y, float z, float f, float t, float s)
+{
+  Cmd cmd = {id, num, x, y, z, f, t, s};
+  return cmd;
+}
+
+static void assertSame(const Cmd &a, const Cmd &b)
+{
+  TEST_ASSERT_EQUAL_CHAR(a.id, b.id);
+  TEST_ASSERT_EQUAL_INT(a.num, b.num);
+  const float va[6] = {a.valueX, a.valueY, a.valueZ, a.valueF, a.valueT, a.valueS};
+  const float vb[6] = {b.valueX, b.valueY, b.valueZ, b.valueF, b.valueT, b.valueS};
+  for (int i = 0; i < 6; i++)
+  {
+    if (isnan(va[i]))
+      TEST_ASSERT_FLOAT_IS_NAN(vb[i]);
+    else
+      TEST_ASSERT_EQUAL_FLOAT(va[i], vb[i]);
+  }
+}
+
+static void test_round_trip()
+{
+  const Cmd program[] = {
+      make('G', 28, NAN, NAN, NAN, 0, 0, NAN),
+      make('G', 1, 200.5f, -100.25f, 150, 3000, 0, NAN),
+      make('G', 0, NAN, NAN, 50, 0, 0, NAN),   // only Z given
+      make('M', 3, NAN, NAN, NAN, 0, 0.4f, 80), // T and S
+      make('G', 4, NAN, NAN, NAN, 0, 0.2f, NAN),
+      make('G', 6, 12345, -6789, 42, 0, 0.01f, NAN),
+      make('M', 701, NAN, NAN, NAN, 0, 2, 3), // number past the one-byte opcode
+      make('M', 220, NAN, NAN, NAN, 0, 0, 150)};
+  const int n = sizeof(program) / sizeof(program[0]);
+
+  ProgramStore store;
+  store.startRecording();
+  for (int i = 0; i < n; i++)
+    TEST_ASSERT_TRUE(store.record(program[i]));
+  TEST_ASSERT_TRUE(store.stopRecording());
+
+  // a fresh instance reads it back, as after a reset
+  ProgramStore player;
+  TEST_ASSERT_TRUE(player.startPlayback(1));
+  Cmd cmd;
+  for (int i = 0; i < n; i++)
+  {
+    TEST_ASSERT_TRUE(player.next(cmd));
+    assertSame(program[i], cmd);
+  }
+  TEST_ASSERT_FALSE(player.next(cmd));
+  TEST_ASSERT_FALSE(player.isPlaying());
+}
+
+static void test_loops()
+{
+  ProgramStore store;
+  store.startRecording();
+  store.record(make('G', 1, 200, 0, 100, 0, 0, NAN));
+  store.record(make('G', 1, 150, 50, 100, 0, 0, NAN));
+  store.stopRecording();
+
+  TEST_ASSERT_TRUE(store.startPlayback(3));
+  Cmd cmd;
+  int count = 0;
+  while (store.next(cmd))
+    count++;
+  TEST_ASSERT_EQUAL_INT(6, count);
+}
+
+static void test_unfinished_recording_not_played()
+{
+  ProgramStore store;
+  store.startRecording();
+  store.record(make('G', 1, 200, 0, 100, 0, 0, NAN));
+  TEST_ASSERT_FALSE(ProgramStore().startPlayback(1)); // no M29 yet
+  TEST_ASSERT_FALSE(store.startPlayback(1));
+}
+
+static void test_full_program_aborts()
+{
+  ProgramStore store;
+  store.startRecording();
+  Cmd move = make('G', 1, 200, 0, 100, 3000, 0, NAN);
+  bool fits = true;
+  for (int i = 0; i < PROGRAM_SIZE && fits; i++)
+    fits = store.record(move);
+  TEST_ASSERT_FALSE(fits);
+  TEST_ASSERT_FALSE(store.isRecording());
+  TEST_ASSERT_FALSE(store.stopRecording());
+  TEST_ASSERT_FALSE(ProgramStore().startPlayback(1));
+}
+
+int runTests()
+{
+  UNITY_BEGIN();
+  RUN_TEST(test_round_trip);
+  RUN_TEST(test_loops);
+  RUN_TEST(test_unfinished_recording_not_played);
+  RUN_TEST(test_full_program_aborts);
+  return UNITY_END();
+}
+
+#ifdef ARDUINO
+void setup()
+{
+  delay(2000); // the board resets when the test runner opens the port
+  runTests();
+}
+
+void loop() {}
+#else
+int main(int argc, char **argv)
+{
+  return runTests();
+}
+#endif
@@ -0,0 +1,104 @@
+#include <unity.h>
+#include "softLimits.h"
+
+void setUp() {}
+void tearDown() {}
+
+static void test_point_inside()
+{
+  TEST_ASSERT_EQUAL(LIMIT_OK, SoftLimits::checkPoint(200, 0, 100));
+  TEST_ASSERT_EQUAL(LIMIT_OK, SoftLimits::checkPoint(-150, 150, Z_MIN));
+  TEST_ASSERT_EQUAL(LIMIT_OK, SoftLimits::checkPoint(0, 200, Z_MAX));
+}
+
+static void test_point_z()
+{
+  TEST_ASSERT_EQUAL(LIMIT_Z, SoftLimits::checkPoint(200, 0, Z_MAX + 1));
+  TEST_ASSERT_EQUAL(LIMIT_Z, SoftLimits::checkPoint(200, 0, Z_MIN - 1));
+}
+
+static void test_point_reach()
+{
+  TEST_ASSERT_EQUAL(LIMIT_REACH, SoftLimits::checkPoint(L1 + L2 + 1, 0, 100));
+  TEST_ASSERT_EQUAL(LIMIT_OK, SoftLimits::checkPoint(L1 + L2 - 1, 0, 100));
+}
+
+static void test_point_r_min()
+{
+  TEST_ASSERT_EQUAL(LIMIT_BASE, SoftLimits::checkPoint(R_MIN - 1, 0, 100));
+  TEST_ASSERT_EQUAL(LIMIT_BASE, SoftLimits::checkPoint(0, 0, 100));
+  TEST_ASSERT_EQUAL(LIMIT_OK, SoftLimits::checkPoint(R_MIN + 1, 0, 100));
+}
+
+static void test_move_inside()
+{
+  TEST_ASSERT_EQUAL(LIMIT_OK, SoftLimits::checkMove(200, 100, 150, 150, -150, 100));
+  TEST_ASSERT_EQUAL(LIMIT_OK, SoftLimits::checkMove(200, 100, 150, 200, 100, 50)); // pure Z
+}
+
+static void test_move_end_outside()
+{
+  TEST_ASSERT_EQUAL(LIMIT_REACH, SoftLimits::checkMove(200, 0, 100, 400, 0, 100));
+  TEST_ASSERT_EQUAL(LIMIT_Z, SoftLimits::checkMove(200, 0, 100, 200, 0, 300));
+}
+
+// both ends outside R_MIN, the straight line between them inside it
+static void test_move_through_r_min()
+{
+  TEST_ASSERT_EQUAL(LIMIT_BASE, SoftLimits::checkMove(10, 200, 100, 10, -200, 100));
+  TEST_ASSERT_EQUAL(LIMIT_OK, SoftLimits::checkMove(R_MIN + 1, 200, 100, R_MIN + 1, -200, 100));
+}
+
+// the arm swings its elbow over on the way, the path itself is legal
+static void test_move_crossing_x0()
+{
+  TEST_ASSERT_EQUAL(LIMIT_OK, SoftLimits::checkMove(100, 200, 100, -100, 200, 100));
+  TEST_ASSERT_EQUAL(LIMIT_OK, SoftLimits::checkMove(-150, -100, 100, 150, -100, 100));
+  TEST_ASSERT_EQUAL(LIMIT_OK, SoftLimits::checkMove(-100, 200, 100, 0, 200, 100));
+}
+
+// G6 targets are joint angles, on either branch
+static void test_joint_point()
+{
+  float rot, low, high, x, y, z;
+  bool elbow = false;
+  Kinematics::inverse(-150, 150, 100, elbow, rot, low, high);
+  TEST_ASSERT_EQUAL(LIMIT_OK, SoftLimits::checkJointPoint(rot, low, high, x, y, z));
+  TEST_ASSERT_FLOAT_WITHIN(0.01f, -150, x);
+  TEST_ASSERT_FLOAT_WITHIN(0.01f, 150, y);
+  TEST_ASSERT_FLOAT_WITHIN(0.01f, 100, z);
+  TEST_ASSERT_EQUAL(LIMIT_JOINT, SoftLimits::checkJointPoint(rot, JointLimits::lowMax + 0.01f, high, x, y, z));
+  TEST_ASSERT_EQUAL(LIMIT_JOINT, SoftLimits::checkJointPoint(rot, low, JointLimits::highMin - 0.01f, x, y, z));
+  TEST_ASSERT_EQUAL(LIMIT_Z, SoftLimits::checkJointPoint(Kinematics::zToRot(Z_MAX + 5), low, high, x, y, z));
+  TEST_ASSERT_EQUAL(LIMIT_BASE, SoftLimits::checkJointPoint(rot, 0, (float)-PI, x, y, z)); // folded
+}
+
+int runTests()
+{
+  UNITY_BEGIN();
+  RUN_TEST(test_point_inside);
+  RUN_TEST(test_point_z);
+  RUN_TEST(test_point_reach);
+  RUN_TEST(test_point_r_min);
+  RUN_TEST(test_move_inside);
+  RUN_TEST(test_move_end_outside);
+  RUN_TEST(test_move_through_r_min);
+  RUN_TEST(test_move_crossing_x0);
+  RUN_TEST(test_joint_point);
+  return UNITY_END();
+}
+
+#ifdef ARDUINO
+void setup()
+{
+  delay(2000); // the board resets when the test runner opens the port
+  runTests();
+}
+
+void loop() {}
+#else
+int main(int argc, char **argv)
+{
+  return runTests();
+}
+#endif
@@ -0,0 +1,288 @@
+/*
+ * Program cycle-time estimator.
+ *
+ * Times a G-code program from the firmware's own motion rules instead of
+ * running it: each G0/G1 gets its duration from Interpolation (feed, the
+ * 2 s default without F, M220 override), and each joint's travel along the
+ * path, sampled through RobotGeometry, gets the shortest time the stepper
+ * can cover it in at STEPPER_MAX_SPEED/STEPPER_ACCEL. A move takes the
+ * longer of the two. G6 segments take T, or longer if a joint would need
+ * more than its top speed. G4 dwells and blocking M3/M5 (SERVO_MOVE_MS)
+ * add their time; gripper events tied to a move add none. G28 takes the
+ * endstop seeks from where the joints are, the back-off and slow latch,
+ * and the park at the start pose; with HOME_CONCURRENT the higher joint
+ * latches only after the lower one.
+ *
+ * Steps are only issued once per loop() pass, so with a loop period
+ * (-l, default 100 us as in fleetSim) the top speed is rounded down to
+ * whole passes per step. Planned moves and G6 get CPU_STEP_HEADROOM of
+ * that, as CpuBudget allows them; rapids and the G28 park are plain
+ * AccelStepper moves and get all of it, rapids less an M220 override
+ * below 100 %.
+ *
+ * A joint-limited move is one the steppers can't follow at the programmed
+ * feed; the firmware holds the feed down until they can, so the move
+ * takes about the joint time. The count shows how much of the program
+ * runs slower than written.
+ *
+ *   cycleTime [-m] [-l loop_us] program.gcode
+ *       total and breakdown; -m adds one CSV line per timed command on
+ *       stdout: line,command,start_s,time_s,limit
+ */
+
+#include <Arduino.h>
+#include <stdio.h>
+#include <algorithm>
+#include <string>
+#include "config.h"
+#include "command.h"
+#include "interpolation.h"
+#include "robotGeometry.h"
+#include "kinematics.h"
+#include "motionModel.h"
+
+#define PATH_SAMPLE_MM 5.0f  // IK sample spacing along a move
+#define PATH_SAMPLES_MAX 32
+
+using motionModel::Steps;
+
+static float maxStepRate = CPU_STEP_HEADROOM * STEPPER_MAX_SPEED; // steps/s after loop rounding
+static float rapidStepRate = STEPPER_MAX_SPEED;                    // the same without the headroom
+
+static float jointTime(float steps)
+{
+  return motionModel::jointTime(steps, maxStepRate);
+}
+
+static float rapidTime(float steps)
+{
+  return motionModel::jointTime(steps, rapidStepRate);
+}
+
+// G28 from these joint positions, as Homing and finishHoming() run it
+static float homeTime(const Steps &from, const Steps &home)
+{
+  const float sw[3] = {(float)(HOME_HIGHER_DEG * PI / 180.0) * JointDrive::higherStepsPerRad,
+                       (float)(HOME_LOWER_DEG * PI / 180.0) * JointDrive::lowerStepsPerRad,
+                       Kinematics::zToRot(HOME_Z_MM) * JointDrive::rotateStepsPerRad};
+  const float at[3] = {(float)from.higher, (float)from.lower, (float)from.rotate};
+  const float park[3] = {(float)home.higher, (float)home.lower, (float)home.rotate};
+  const float latch = (float)HOME_BACKOFF_STEPS / HOME_LATCH_SPEED;
+  float t[3], parkT = 0;
+  for (int k = 0; k < 3; k++)
+  {
+    t[k] = (fabsf(sw[k] - at[k]) + HOME_BACKOFF_STEPS) / HOME_SEEK_SPEED + latch;
+    parkT = fmaxf(parkT, rapidTime(fabsf(park[k] - sw[k])));
+  }
+  if (!HOME_CONCURRENT)
+    return t[0] + t[1] + t[2] + parkT;
+  // the higher joint latches after the lower one, seeking again if it waited
+  float higher = t[0] - latch;
+  if (higher < t[1])
+    higher = t[1] + 2.0f * HOME_BACKOFF_STEPS / HOME_SEEK_SPEED;
+  return fmaxf(higher + latch, fmaxf(t[1], t[2])) + parkT;
+}
+
+static void usage()
+{
+  fprintf(stderr, "usage: cycleTime [-m] [-l loop_us] program.gcode\n");
+}
+
+int main(int argc, char **argv)
+{
+  bool perMove = false;
+  float loopUs = 100;
+  int arg = 1;
+  while (arg < argc && argv[arg][0] == '-')
+  {
+    std::string opt = argv[arg++];
+    if (opt == "-m")
+      perMove = true;
+    else if (opt == "-l" && arg < argc)
+      loopUs = atof(argv[arg++]);
+    else
+      arg = argc; // unknown option
+  }
+  if (arg >= argc || loopUs < 0)
+  {
+    usage();
+    return 2;
+  }
+  rapidStepRate = motionModel::loopStepRate(loopUs);
+  maxStepRate = CPU_STEP_HEADROOM * rapidStepRate;
+  FILE *in = fopen(argv[arg], "r");
+  if (in == NULL)
+  {
+    perror(argv[arg]);
+    return 1;
+  }
+
+  host::useVirtualClock(true);
+  Command command;
+  Interpolation interpolator;
+  RobotGeometry geometry;
+  interpolator.setCurrentPos(INITIAL_X, INITIAL_Y, INITIAL_Z);
+  Steps joints = motionModel::solve(geometry, INITIAL_X, INITIAL_Y, INITIAL_Z);
+  float feedScale = 1.0f;
+  bool armed = false; // sync events wait for the next move
+
+  double total = 0, motion = 0, dwell = 0, gripper = 0;
+  long lineNo = 0, moves = 0, jointLimited = 0;
+  if (perMove)
+    printf("line,command,start_s,time_s,limit\n");
+
+  char buf[512];
+  while (fgets(buf, sizeof(buf), in))
+  {
+    lineNo++;
+    std::string line = motionModel::clean(buf);
+    if (line.empty())
+      continue;
+    if (!command.processMessage(line.c_str()))
+    {
+      fprintf(stderr, "%s:%ld: cannot parse '%s'\n", argv[arg], lineNo, line.c_str());
+      return 1;
+    }
+    Cmd cmd = command.getCmd();
+
+    float t = 0;
+    const char *limit = NULL;
+    if (cmd.id == 'G' && (cmd.num == 0 || cmd.num == 1))
+    {
+      if (isnan(cmd.valueX))
+        cmd.valueX = interpolator.getXPosmm();
+      if (isnan(cmd.valueY))
+        cmd.valueY = interpolator.getYPosmm();
+      if (isnan(cmd.valueZ))
+        cmd.valueZ = interpolator.getZPosmm();
+
+      // same feed handling and move classes as cmdMove()
+      float x0 = interpolator.getXPosmm(), y0 = interpolator.getYPosmm(), z0 = interpolator.getZPosmm();
+      bool planar = fabsf(cmd.valueX - x0) > MOVE_EPS_MM || fabsf(cmd.valueY - y0) > MOVE_EPS_MM;
+      if (!planar && cmd.num == 0 && !armed)
+      {
+        // rapid lift/drop runs the rotate joint alone at its own limits,
+        // the override scales its top speed up to 100 %
+        Steps next = motionModel::solve(geometry, x0, y0, cmd.valueZ);
+        float rate = motionModel::loopStepRate(loopUs, STEPPER_MAX_SPEED * fminf(feedScale, 1.0f));
+        t = motionModel::jointTime(labs(next.rotate - joints.rotate), rate);
+        limit = "rapid";
+        joints = next;
+        interpolator.setCurrentPos(cmd.valueX, cmd.valueY, cmd.valueZ);
+        motion += t;
+        moves++;
+        if (perMove)
+          printf("%ld,%s,%.4f,%.4f,%s\n", lineNo, line.c_str(), total, (double)t, limit);
+        total += t;
+        continue;
+      }
+      armed = false;
+      float v = (cmd.valueF > 0) ? (cmd.valueF / 60.0f) : 0.0f;
+      interpolator.setInterpolation(cmd.valueX, cmd.valueY, cmd.valueZ, v);
+      t = interpolator.getDuration() / feedScale;
+      limit = "feed";
+
+      float dx = cmd.valueX - x0, dy = cmd.valueY - y0, dz = cmd.valueZ - z0;
+      int n = (int)ceilf(sqrtf(dx * dx + dy * dy + dz * dz) / PATH_SAMPLE_MM);
+      if (n < 1)
+        n = 1;
+      if (n > PATH_SAMPLES_MAX)
+        n = PATH_SAMPLES_MAX;
+      Steps travel = {0, 0, 0};
+      for (int i = 1; i <= n; i++)
+      {
+        float u = (float)i / n;
+        Steps next = motionModel::solve(geometry, x0 + u * dx, y0 + u * dy, z0 + u * dz);
+        travel.higher += labs(next.higher - joints.higher);
+        travel.lower += labs(next.lower - joints.lower);
+        travel.rotate += labs(next.rotate - joints.rotate);
+        joints = next;
+      }
+      const float jt[3] = {jointTime(travel.higher), jointTime(travel.lower), jointTime(travel.rotate)};
+      const char *names[3] = {"higher", "lower", "rotate"};
+      for (int k = 0; k < 3; k++)
+      {
+        if (jt[k] > t)
+        {
+          t = jt[k];
+          limit = names[k];
+        }
+      }
+      if (limit[0] != 'f')
+        jointLimited++;
+
+      interpolator.setCurrentPos(cmd.valueX, cmd.valueY, cmd.valueZ);
+      motion += t;
+      moves++;
+    }
+    else if (cmd.id == 'G' && cmd.num == 6)
+    {
+      // constant-rate joint segment, capped at the stepper's top speed
+      Steps next = {lroundf(cmd.valueX), lroundf(cmd.valueY), lroundf(cmd.valueZ)};
+      long steps = std::max(labs(next.higher - joints.higher),
+                            std::max(labs(next.lower - joints.lower), labs(next.rotate - joints.rotate)));
+      t = fmaxf(cmd.valueT, steps / maxStepRate);
+      limit = (t > cmd.valueT) ? "speed" : "segment";
+      joints = next;
+      armed = false;
+      motion += t;
+      moves++;
+    }
+    else if (cmd.id == 'G' && cmd.num == 4)
+    {
+      t = cmd.valueT;
+      limit = "dwell";
+      dwell += t;
+    }
+    else if (cmd.id == 'G' && (cmd.num == 28 || cmd.num == 92))
+    {
+      // homing, then the same position bookkeeping as finishHoming() and cmdSetPosition()
+      if (cmd.num == 28)
+      {
+        Steps home = motionModel::solve(geometry, INITIAL_X, INITIAL_Y, INITIAL_Z);
+        t = homeTime(joints, home);
+        limit = "home";
+        motion += t;
+        interpolator.setCurrentPos(INITIAL_X, INITIAL_Y, INITIAL_Z);
+        joints = home;
+      }
+      else
+      {
+        interpolator.setCurrentPos(isnan(cmd.valueX) ? interpolator.getXPosmm() : cmd.valueX,
+                                   isnan(cmd.valueY) ? interpolator.getYPosmm() : cmd.valueY,
+                                   isnan(cmd.valueZ) ? interpolator.getZPosmm() : cmd.valueZ);
+      }
+    }
+    else if (cmd.id == 'M' && (cmd.num == 3 || cmd.num == 5))
+    {
+      if (isnan(cmd.valueS) && cmd.valueT <= 0)
+      {
+        t = SERVO_MOVE_MS * 1e-3f;
+        limit = "gripper";
+        gripper += t;
+      }
+      else
+        armed = true;
+    }
+    else if (cmd.id == 'M' && cmd.num == 220 && !isnan(cmd.valueS))
+    {
+      long pct = lroundf(cmd.valueS); // clamped like setFeedOverride()
+      if (pct < FEED_OVERRIDE_MIN)
+        pct = FEED_OVERRIDE_MIN;
+      if (pct > FEED_OVERRIDE_MAX)
+        pct = FEED_OVERRIDE_MAX;
+      feedScale = pct * 0.01f;
+    }
+
+    if (perMove && limit)
+      printf("%ld,%s,%.4f,%.4f,%s\n", lineNo, line.c_str(), total, (double)t, limit);
+    total += t;
+  }
+  fclose(in);
+
+  fprintf(perMove ? stderr : stdout,
+          "%ld lines, %ld moves (%ld joint-limited)\n"
+          "cycle %.3f s: motion %.3f s, dwell %.3f s, gripper %.3f s\n",
+          lineNo, moves, jointLimited, total, motion, dwell, gripper);
+  return 0;
+}
@@ -0,0 +1,318 @@
+/*
+ * Fleet simulator.
+ *
+ * Runs many independent RobotArm instances, each with its own steppers,
+ * serial link and clock, over a pool of threads. Every arm is fed one of
+ * the given programs the way a character-counting sender streams it over
+ * the serial port, and runs until the program is done and the arm stands
+ * still. Time is simulated: each loop() pass advances the arm's clock by
+ * the loop period, delays in the firmware (G4, blocking gripper moves)
+ * advance it by their length.
+ *
+ * Arms take the programs in turn; with -o they also take the feed overrides
+ * in turn (sent as M220 before the program), which makes tuning sweeps a
+ * matter of one command line. One CSV line per arm goes to stdout:
+ *   arm,program,override,cycle_s,finished,faults,rejected,x,y,z
+ * where x,y,z is the final position from the joint steps. Faults count
+ * "!!" and "rs" replies, rejected the moves refused by the soft limits.
+ *
+ * Every arm starts with its own copy of the host storage file, so programs
+ * that record (M28) or teach stations (M700) only change their own arm's
+ * EEPROM; the file itself is left as it was.
+ *
+ * usage: fleetSim [-n arms] [-j threads] [-l loop_us] [-t max_s]
+ *                 [-o pct,pct,...] program.gcode [program.gcode ...]
+ */
+
+#include <Arduino.h>
+#include <stdio.h>
+#include <string.h>
+#include <atomic>
+#include <chrono>
+#include <string>
+#include <thread>
+#include <vector>
+#include "config.h"
+#include "pinout.h"
+#include "kinematics.h"
+#include "robotArm.h"
+#include "simEndstops.h"
+#include "storage.h"
+
+struct Program
+{
+  std::string name;
+  std::string text; // lines end in \r\n like a terminal sends them
+};
+
+// Serial input from a sender that counts characters, as streaming hosts do:
+// the next line goes out once it fits the firmware's free input buffer, so
+// none of it is dropped. A line longer than the whole buffer goes out when
+// the buffer is empty, and is answered with an error.
+class ProgramStream : public Stream
+{
+public:
+  ProgramStream(const std::string &prefix, const std::string &text)
+      : text_(prefix + text), pos_(0), sent_(0), arm_(NULL) {}
+  void attach(const RobotArm *arm) { arm_ = arm; }
+  int available() override
+  {
+    if (pos_ == sent_ && sent_ < text_.size() && arm_)
+    {
+      size_t end = text_.find('\n', sent_);
+      end = (end == std::string::npos) ? text_.size() : end + 1;
+      int room = arm_->getRxFree();
+      if ((int)(end - sent_) <= room || room == RX_BUFFER_SIZE - 1)
+        sent_ = end;
+    }
+    return sent_ - pos_;
+  }
+  int read() override
+  {
+    int c = peek();
+    if (c >= 0)
+      pos_++;
+    return c;
+  }
+  int peek() override
+  {
+    return (pos_ < sent_) ? (uint8_t)text_[pos_] : -1;
+  }
+  size_t write(uint8_t) override { return 0; }
+  using Print::write;
+
+  // nothing left to send
+  bool done() const { return pos_ == text_.size(); }
+
+private:
+  std::string text_;
+  size_t pos_;
+  size_t sent_; // handed to the wire so far
+  const RobotArm *arm_;
+};
+
+// Serial output that only looks for fault replies and rejected moves
+class WatchPort : public HardwareSerial
+{
+public:
+  WatchPort() : HardwareSerial(-1, -1), faults(0), rejected(0) {}
+  size_t write(uint8_t c) override
+  {
+    if (c == '\n')
+    {
+      if (line_ == "!!\r" || line_ == "rs\r")
+        faults++;
+      else if (line_.compare(0, 17, "// Move rejected:") == 0)
+        rejected++;
+      line_.clear();
+    }
+    else if (line_.size() < 32)
+    {
+      line_ += (char)c;
+    }
+    return 1;
+  }
+  size_t write(const uint8_t *buf, size_t n) override
+  {
+    for (size_t i = 0; i < n; i++)
+      write(buf[i]);
+    return n;
+  }
+  using Print::write;
+
+  long faults;
+  long rejected;
+
+private:
+  std::string line_;
+};
+
+struct Job
+{
+  const Program *program;
+  int override; // percent, 0 = none
+  double cycleS;
+  bool finished;
+  long faults;
+  long rejected;
+  float x, y, z;
+};
+
+static void runArm(Job &job, const host::Eeprom &storage, unsigned long loopUs, double maxS)
+{
+  host::Clock clock;
+  host::bindClock(&clock);
+  host::Eeprom eeprom(storage);
+  host::bindEeprom(&eeprom);
+
+  RampsStepper higher(X_STEP_PIN, X_DIR_PIN, X_ENABLE_PIN, INVERSE_X_STEPPER, JointDrive::higherStepsPerRad);
+  RampsStepper lower(Y_STEP_PIN, Y_DIR_PIN, Y_ENABLE_PIN, INVERSE_Y_STEPPER, JointDrive::lowerStepsPerRad);
+  RampsStepper rotate(Z_STEP_PIN, Z_DIR_PIN, Z_ENABLE_PIN, INVERSE_Z_STEPPER, JointDrive::rotateStepsPerRad);
+  Servo_Gripper gripper(SERVO_PIN, SERVO_GRIP_DEGREE, SERVO_UNGRIP_DEGREE);
+  Equipment led(LED_PIN);
+  WatchPort port;
+  SerialTx tx(port);
+
+  std::string prefix;
+  if (job.override > 0)
+    prefix = "M220 S" + std::to_string(job.override) + "\r\n";
+  ProgramStream in(prefix, job.program->text);
+
+  RobotArm arm(higher, lower, rotate, gripper, led, tx, &in);
+  in.attach(&arm);
+  arm.setup();
+  SimEndstops endstops(higher, lower, rotate);
+  endstops.powerOnAt(INITIAL_X, INITIAL_Y, INITIAL_Z); // where operators leave it
+  host::bindPins(&endstops);
+  unsigned long start = clock.us;
+  unsigned long limit = start + (unsigned long)(maxS * 1e6);
+
+  job.finished = false;
+  while (clock.us < limit)
+  {
+    arm.loop();
+    clock.us += loopUs;
+    if (in.done() && arm.isIdle())
+    {
+      job.finished = true;
+      break;
+    }
+  }
+  tx.flush();
+
+  job.cycleS = (clock.us - start) * 1e-6;
+  job.faults = port.faults;
+  job.rejected = port.rejected;
+  Kinematics::forward(rotate.getPositionRad(), lower.getPositionRad(), higher.getPositionRad(),
+                      job.x, job.y, job.z);
+  host::bindPins(NULL);
+  host::bindEeprom(NULL);
+  host::bindClock(NULL);
+}
+
+static bool loadProgram(const char *path, Program &program)
+{
+  FILE *f = fopen(path, "r");
+  if (f == NULL)
+  {
+    perror(path);
+    return false;
+  }
+  program.name = path;
+  char buf[512];
+  while (fgets(buf, sizeof(buf), f))
+  {
+    size_t n = strcspn(buf, "\r\n");
+    program.text.append(buf, n);
+    program.text += "\r\n";
+  }
+  fclose(f);
+  return true;
+}
+
+static void usage()
+{
+  fprintf(stderr, "usage: fleetSim [-n arms] [-j threads] [-l loop_us] [-t max_s] [-o pct,pct,...]\n"
+                  "                program.gcode [program.gcode ...]\n");
+}
+
+int main(int argc, char **argv)
+{
+  int arms = 0;
+  unsigned threads = std::thread::hardware_concurrency();
+  unsigned long loopUs = 100;
+  double maxS = 3600;
+  std::vector<int> overrides;
+
+  int arg = 1;
+  while (arg + 1 < argc && argv[arg][0] == '-')
+  {
+    std::string opt = argv[arg];
+    const char *val = argv[arg + 1];
+    if (opt == "-n")
+      arms = atoi(val);
+    else if (opt == "-j")
+      threads = atoi(val);
+    else if (opt == "-l")
+      loopUs = strtoul(val, NULL, 10);
+    else if (opt == "-t")
+      maxS = atof(val);
+    else if (opt == "-o")
+    {
+      for (const char *p = val; *p; p += (*p == ',') ? 1 : 0)
+      {
+        char *end;
+        overrides.push_back((int)strtol(p, &end, 10));
+        if (end == p || (*end != ',' && *end != 0))
+        {
+          usage();
+          return 2;
+        }
+        p = end;
+      }
+    }
+    else
+    {
+      usage();
+      return 2;
+    }
+    arg += 2;
+  }
+  if (arg >= argc || loopUs == 0 || maxS <= 0)
+  {
+    usage();
+    return 2;
+  }
+
+  std::vector<Program> programs(argc - arg);
+  for (size_t i = 0; i < programs.size(); i++)
+  {
+    if (!loadProgram(argv[arg + i], programs[i]))
+      return 1;
+  }
+  if (arms <= 0)
+    arms = programs.size() * (overrides.empty() ? 1 : overrides.size());
+  if (threads == 0)
+    threads = 1;
+
+  std::vector<Job> jobs(arms);
+  for (int i = 0; i < arms; i++)
+  {
+    jobs[i].program = &programs[i % programs.size()];
+    jobs[i].override = overrides.empty() ? 0 : overrides[(i / programs.size()) % overrides.size()];
+  }
+
+  host::Eeprom storage(STORAGE_SIZE);
+  Storage::read(0, storage.bytes.data(), STORAGE_SIZE);
+
+  auto t0 = std::chrono::steady_clock::now();
+  std::atomic<int> next(0);
+  std::vector<std::thread> pool;
+  for (unsigned t = 0; t < threads && t < (unsigned)arms; t++)
+  {
+    pool.push_back(std::thread([&]() {
+      for (int i = next++; i < arms; i = next++)
+        runArm(jobs[i], storage, loopUs, maxS);
+    }));
+  }
+  for (size_t t = 0; t < pool.size(); t++)
+    pool[t].join();
+  double wallS = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+
+  double simS = 0;
+  int failed = 0;
+  printf("arm,program,override,cycle_s,finished,faults,rejected,x,y,z\n");
+  for (int i = 0; i < arms; i++)
+  {
+    const Job &j = jobs[i];
+    printf("%d,%s,%d,%.4f,%d,%ld,%ld,%.2f,%.2f,%.2f\n", i, j.program->name.c_str(),
+           j.override ? j.override : 100, j.cycleS, j.finished ? 1 : 0, j.faults, j.rejected,
+           (double)j.x, (double)j.y, (double)j.z);
+    simS += j.cycleS;
+    if (!j.finished || j.faults)
+      failed++;
+  }
+  fprintf(stderr, "%d arms on %u threads: %.1f s simulated in %.2f s (%.0fx), %d with faults or unfinished\n",
+          arms, (unsigned)pool.size(), simS, wallS, simS / wallS, failed);
+  return failed ? 1 : 0;
+}
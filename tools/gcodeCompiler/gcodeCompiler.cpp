@@ -0,0 +1,315 @@
+/*
+ * Host-side G-code compiler.
+ *
+ * Runs every G0/G1 through the firmware's own Interpolation and RobotGeometry
+ * on a virtual clock and writes the result as G6 joint segments (absolute step
+ * targets for the higher/lower/rotate joints plus a duration), followed by a
+ * G92 that keeps the firmware's Cartesian position in sync. All other commands
+ * pass through unchanged. The arm then does no IK or planning for the program.
+ *
+ * G6 runs each joint at a constant rate, so the segments are timed for the
+ * steppers, not only the feed. No segment asks a joint for more than
+ * CPU_STEP_HEADROOM of the rate the loop can step (-l, default 100 us as in
+ * fleetSim), or the firmware would stretch it itself, and a move takes at
+ * least the time its busiest joint needs for its travel at STEPPER_MAX_SPEED
+ * and STEPPER_ACCEL (motionModel::jointTime, as cycleTime has it). Steps go
+ * out on whole loop passes, so each segment's T is rounded up to match. The
+ * total reported is the sum of the segment times written.
+ *
+ * Every move, G92 and the G28 park pose go through the firmware's SoftLimits
+ * first; the first one it would refuse stops the compile with its line. Where
+ * a move crosses x = 0 the elbow changes branch: the path is split there and
+ * the swing goes out as a segment of its own, timed as a joint-space move.
+ *
+ * Gripper events tied to the next move (M3/M5 S<percent> or T<seconds>) are
+ * resolved here too: they are re-emitted as "S0" right before the segment in
+ * which they fall due, and the firmware fires them as that segment starts.
+ *
+ * The stream assumes the arm is homed (G28) when it starts.
+ *
+ * usage: gcodeCompiler [-s segment_ms] [-l loop_us] input.gcode [output.gcode]
+ */
+
+#include <Arduino.h>
+#include <stdio.h>
+#include <algorithm>
+#include <string>
+#include <vector>
+#include "config.h"
+#include "command.h"
+#include "interpolation.h"
+#include "robotGeometry.h"
+#include "kinematics.h"
+#include "softLimits.h"
+#include "motionModel.h"
+
+using motionModel::Steps;
+
+// M3/M5 armed for the next move
+struct PendingSync
+{
+  int num;
+  bool atProgress; // else seconds before the end
+  float value;
+};
+
+// one G6 of a move before it is timed
+struct Segment
+{
+  Steps joints;
+  float t;        // end time on the move's feed profile
+  float progress; // of the move at the end
+  bool swing;     // elbow branch change at x = 0, no feed time of its own
+};
+
+static void usage()
+{
+  fprintf(stderr, "usage: gcodeCompiler [-s segment_ms] [-l loop_us] input.gcode [output.gcode]\n");
+}
+
+int main(int argc, char **argv)
+{
+  float segmentS = 0.01f;
+  float loopUs = 100;
+  int arg = 1;
+  while (arg < argc && argv[arg][0] == '-')
+  {
+    std::string opt = argv[arg++];
+    if (opt == "-s" && arg < argc)
+      segmentS = atof(argv[arg++]) * 1e-3f;
+    else if (opt == "-l" && arg < argc)
+      loopUs = atof(argv[arg++]);
+    else
+      arg = argc; // unknown option
+  }
+  if (arg >= argc || segmentS <= 0 || loopUs < 0)
+  {
+    usage();
+    return 2;
+  }
+  const float maxStepRate = CPU_STEP_HEADROOM * motionModel::loopStepRate(loopUs);
+  FILE *in = fopen(argv[arg], "r");
+  if (in == NULL)
+  {
+    perror(argv[arg]);
+    return 1;
+  }
+  FILE *out = (arg + 1 < argc) ? fopen(argv[arg + 1], "w") : stdout;
+  if (out == NULL)
+  {
+    perror(argv[arg + 1]);
+    return 1;
+  }
+
+  host::useVirtualClock(true);
+  Command command;
+  Interpolation interpolator;
+  RobotGeometry geometry;
+
+  interpolator.setCurrentPos(INITIAL_X, INITIAL_Y, INITIAL_Z);
+  Steps joints = motionModel::solve(geometry, INITIAL_X, INITIAL_Y, INITIAL_Z);
+
+  std::vector<PendingSync> pendingSync;
+  long lineNo = 0, moves = 0, segments = 0;
+  double totalS = 0;
+  char buf[512];
+  while (fgets(buf, sizeof(buf), in))
+  {
+    lineNo++;
+    std::string line = motionModel::clean(buf);
+    if (line.empty())
+      continue;
+
+    if (!command.processMessage(line.c_str()))
+    {
+      fprintf(stderr, "%s:%ld: cannot parse '%s'\n", argv[arg], lineNo, line.c_str());
+      return 1;
+    }
+    Cmd cmd = command.getCmd();
+    if (cmd.id == 'G' && cmd.num == 6)
+    {
+      fprintf(stderr, "%s:%ld: input is already compiled\n", argv[arg], lineNo);
+      return 1;
+    }
+    if (cmd.id == 'M' && (cmd.num == 3 || cmd.num == 5) && (!isnan(cmd.valueS) || cmd.valueT > 0))
+    {
+      PendingSync p;
+      p.num = cmd.num;
+      p.atProgress = !isnan(cmd.valueS);
+      p.value = p.atProgress ? cmd.valueS * 0.01f : cmd.valueT;
+      pendingSync.push_back(p);
+      continue;
+    }
+    if (cmd.id != 'G' || (cmd.num != 0 && cmd.num != 1 && cmd.num != 28 && cmd.num != 92))
+    {
+      fprintf(out, "%s\n", line.c_str());
+      continue;
+    }
+
+    if (isnan(cmd.valueX))
+      cmd.valueX = interpolator.getXPosmm();
+    if (isnan(cmd.valueY))
+      cmd.valueY = interpolator.getYPosmm();
+    if (isnan(cmd.valueZ))
+      cmd.valueZ = interpolator.getZPosmm();
+
+    // what the firmware would refuse when it queues the line
+    if (cmd.num == 28)
+    {
+      cmd.valueX = INITIAL_X;
+      cmd.valueY = INITIAL_Y;
+      cmd.valueZ = INITIAL_Z;
+    }
+    uint8_t error = (cmd.num == 0 || cmd.num == 1)
+                        ? SoftLimits::checkMove(interpolator.getXPosmm(), interpolator.getYPosmm(),
+                                                interpolator.getZPosmm(), cmd.valueX, cmd.valueY, cmd.valueZ)
+                        : SoftLimits::checkPoint(cmd.valueX, cmd.valueY, cmd.valueZ);
+    if (error != LIMIT_OK)
+    {
+      fprintf(stderr, "%s:%ld: %s: '%s'\n", argv[arg], lineNo, SoftLimits::describe(error), line.c_str());
+      return 1;
+    }
+
+    if (cmd.num == 28 || cmd.num == 92)
+    {
+      // the firmware re-seeds its position; follow it and pass the line on
+      if (cmd.num == 28)
+        joints = motionModel::solve(geometry, INITIAL_X, INITIAL_Y, INITIAL_Z);
+      interpolator.setCurrentPos(cmd.valueX, cmd.valueY, cmd.valueZ);
+      fprintf(out, "%s\n", line.c_str());
+      continue;
+    }
+
+    // G0/G1, same feed handling as cmdMove()
+    float v = (cmd.valueF > 0) ? (cmd.valueF / 60.0f) : 0.0f;
+    host::setMicros(0);
+    interpolator.setInterpolation(cmd.valueX, cmd.valueY, cmd.valueZ, v);
+    float duration = interpolator.getDuration();
+    if (duration <= 0)
+    {
+      // nothing to overlap with, the events go out with the next segment
+      for (size_t k = 0; k < pendingSync.size(); k++)
+        fprintf(out, "M%d S0\n", pendingSync[k].num);
+      pendingSync.clear();
+      continue;
+    }
+
+    // the joint targets along the feed profile, one segment per change
+    std::vector<Segment> segs;
+    Steps start = joints;
+    float px = interpolator.getXPosmm(), py = interpolator.getYPosmm(), pz = interpolator.getZPosmm();
+    float pt = 0, pp = 0;
+    long n = (long)ceilf(duration / segmentS);
+    for (long i = 1; i <= n; i++)
+    {
+      float t = (i == n) ? duration : i * segmentS;
+      host::setMicros((unsigned long)lroundf(t * 1e6f));
+      interpolator.updateActualPosition();
+      float x = interpolator.getXPosmm(), y = interpolator.getYPosmm(), z = interpolator.getZPosmm();
+      bool elbow = geometry.getElbow();
+      Steps next = motionModel::solve(geometry, x, y, z);
+      if (geometry.getElbow() != elbow)
+      {
+        // up to x = 0 on the old branch, over to the new one, then on
+        float u = px / (px - x);
+        float cy = py + u * (y - py), cz = pz + u * (z - pz);
+        float ct = pt + u * (t - pt), cp = pp + u * (interpolator.getProgress() - pp);
+        geometry.setElbow(elbow);
+        Segment before = {motionModel::solve(geometry, 0, cy, cz), ct, cp, false};
+        geometry.setElbow(!elbow);
+        Segment over = {motionModel::solve(geometry, 0, cy, cz), ct, cp, true};
+        if (before.joints.higher != joints.higher || before.joints.lower != joints.lower ||
+            before.joints.rotate != joints.rotate)
+          segs.push_back(before);
+        segs.push_back(over);
+        next = motionModel::solve(geometry, x, y, z);
+        joints = over.joints;
+      }
+      if (next.higher != joints.higher || next.lower != joints.lower || next.rotate != joints.rotate || i == n)
+      {
+        Segment seg = {next, t, interpolator.getProgress(), false};
+        segs.push_back(seg);
+      }
+      joints = next;
+      px = x;
+      py = y;
+      pz = z;
+      pt = t;
+      pp = interpolator.getProgress();
+    }
+
+    // The steppers set the pace where the feed asks for more than they
+    // give: no segment runs a joint past the step rate, and the path takes
+    // at least what its busiest joint needs to cover its travel. A swing
+    // gets the time of a joint-space move of its own.
+    std::vector<float> dts(segs.size());
+    std::vector<long> steps(segs.size());
+    Steps travel = {0, 0, 0};
+    float pathS = 0, tPrev = 0;
+    Steps from = start;
+    for (size_t i = 0; i < segs.size(); i++)
+    {
+      Steps d = {labs(segs[i].joints.higher - from.higher), labs(segs[i].joints.lower - from.lower),
+                 labs(segs[i].joints.rotate - from.rotate)};
+      steps[i] = std::max(d.higher, std::max(d.lower, d.rotate));
+      if (segs[i].swing)
+      {
+        dts[i] = motionModel::jointTime(steps[i], maxStepRate);
+      }
+      else
+      {
+        dts[i] = fmaxf(segs[i].t - tPrev, steps[i] / maxStepRate);
+        pathS += dts[i];
+        travel.higher += d.higher;
+        travel.lower += d.lower;
+        travel.rotate += d.rotate;
+      }
+      tPrev = segs[i].t;
+      from = segs[i].joints;
+    }
+    long most = std::max(travel.higher, std::max(travel.lower, travel.rotate));
+    float stretch = (pathS > 0) ? fmaxf(1.0f, motionModel::jointTime(most, maxStepRate) / pathS) : 1.0f;
+
+    // on the loop's whole passes per step, then out with the events due
+    float moveS = 0;
+    for (size_t i = 0; i < segs.size(); i++)
+    {
+      dts[i] = motionModel::stepRunTime(segs[i].swing ? dts[i] : dts[i] * stretch, steps[i], loopUs);
+      moveS += dts[i];
+    }
+    float remaining = moveS;
+    for (size_t i = 0; i < segs.size(); i++)
+    {
+      const Segment &seg = segs[i];
+      remaining -= dts[i];
+      bool last = (i + 1 == segs.size());
+      for (size_t k = 0; k < pendingSync.size();)
+      {
+        const PendingSync &p = pendingSync[k];
+        bool due = p.atProgress ? (seg.progress >= p.value) : (remaining <= p.value);
+        if (due || last)
+        {
+          fprintf(out, "M%d S0\n", p.num);
+          pendingSync.erase(pendingSync.begin() + k);
+        }
+        else
+        {
+          k++;
+        }
+      }
+      fprintf(out, "G6 X%ld Y%ld Z%ld T%.6f\n", seg.joints.higher, seg.joints.lower, seg.joints.rotate, (double)dts[i]);
+      segments++;
+    }
+    totalS += moveS;
+    // land exactly on the commanded point, as the firmware would
+    interpolator.setCurrentPos(cmd.valueX, cmd.valueY, cmd.valueZ);
+    fprintf(out, "G92 X%.4f Y%.4f Z%.4f\n", (double)cmd.valueX, (double)cmd.valueY, (double)cmd.valueZ);
+    moves++;
+  }
+
+  fprintf(stderr, "%ld lines, %ld moves -> %ld segments, %.2f s of motion\n", lineNo, moves, segments, totalS);
+  if (out != stdout)
+    fclose(out);
+  fclose(in);
+  return 0;
+}
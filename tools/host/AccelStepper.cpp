@@ -0,0 +1,181 @@
+#include "AccelStepper.h"
+
+AccelStepper::AccelStepper(uint8_t, uint8_t pin1, uint8_t pin2)
+    : _stepPin(pin1), _dirPin(pin2), _currentPos(0), _targetPos(0), _speed(0.0), _maxSpeed(1.0), _acceleration(0.0),
+      _stepInterval(0), _lastStepTime(0), _n(0), _c0(0.0), _cn(0.0), _cmin(1.0),
+      _direction(false)
+{
+  setAcceleration(1);
+  setMaxSpeed(1);
+}
+
+void AccelStepper::moveTo(long absolute)
+{
+  if (_targetPos != absolute)
+  {
+    _targetPos = absolute;
+    computeNewSpeed();
+  }
+}
+
+void AccelStepper::move(long relative)
+{
+  moveTo(_currentPos + relative);
+}
+
+bool AccelStepper::runSpeed()
+{
+  if (!_stepInterval)
+    return false;
+
+  unsigned long time = micros();
+  if (time - _lastStepTime >= _stepInterval)
+  {
+    _currentPos += _direction ? 1 : -1;
+    digitalWrite(_dirPin, _direction ? HIGH : LOW);
+    digitalWrite(_stepPin, HIGH);
+    digitalWrite(_stepPin, LOW);
+    _lastStepTime = time;
+    return true;
+  }
+  return false;
+}
+
+bool AccelStepper::run()
+{
+  if (runSpeed())
+    computeNewSpeed();
+  return _speed != 0.0 || distanceToGo() != 0;
+}
+
+bool AccelStepper::runSpeedToPosition()
+{
+  if (_targetPos == _currentPos)
+    return false;
+  _direction = _targetPos > _currentPos;
+  return runSpeed();
+}
+
+void AccelStepper::computeNewSpeed()
+{
+  long distanceTo = distanceToGo();
+  long stepsToStop = (long)((_speed * _speed) / (2.0 * _acceleration));
+
+  if (distanceTo == 0 && stepsToStop <= 1)
+  {
+    _stepInterval = 0;
+    _speed = 0.0;
+    _n = 0;
+    return;
+  }
+
+  if (distanceTo > 0)
+  {
+    if (_n > 0)
+    {
+      if (stepsToStop >= distanceTo || !_direction)
+        _n = -stepsToStop; // start decelerating
+    }
+    else if (_n < 0)
+    {
+      if (stepsToStop < distanceTo && _direction)
+        _n = -_n; // start accelerating
+    }
+  }
+  else if (distanceTo < 0)
+  {
+    if (_n > 0)
+    {
+      if (stepsToStop >= -distanceTo || _direction)
+        _n = -stepsToStop;
+    }
+    else if (_n < 0)
+    {
+      if (stepsToStop < -distanceTo && !_direction)
+        _n = -_n;
+    }
+  }
+
+  if (_n == 0)
+  {
+    _cn = _c0; // first step from stopped
+    _direction = distanceTo > 0;
+  }
+  else
+  {
+    _cn = _cn - ((2.0 * _cn) / ((4.0 * _n) + 1));
+    if (_cn < _cmin)
+      _cn = _cmin;
+  }
+  _n++;
+  _stepInterval = _cn;
+  _speed = 1000000.0 / _cn;
+  if (!_direction)
+    _speed = -_speed;
+}
+
+void AccelStepper::setMaxSpeed(float speed)
+{
+  if (speed < 0.0)
+    speed = -speed;
+  if (_maxSpeed != speed)
+  {
+    _maxSpeed = speed;
+    _cmin = 1000000.0 / speed;
+    if (_n > 0)
+    {
+      _n = (long)((_speed * _speed) / (2.0 * _acceleration));
+      computeNewSpeed();
+    }
+  }
+}
+
+void AccelStepper::setAcceleration(float acceleration)
+{
+  if (acceleration == 0.0)
+    return;
+  if (acceleration < 0.0)
+    acceleration = -acceleration;
+  if (_acceleration != acceleration)
+  {
+    _n = _n * (_acceleration / acceleration);
+    _c0 = 0.676 * sqrt(2.0 / acceleration) * 1000000.0;
+    _acceleration = acceleration;
+    computeNewSpeed();
+  }
+}
+
+void AccelStepper::setSpeed(float speed)
+{
+  if (speed == _speed)
+    return;
+  if (speed > _maxSpeed)
+    speed = _maxSpeed;
+  if (speed < -_maxSpeed)
+    speed = -_maxSpeed;
+  if (speed == 0.0)
+    _stepInterval = 0;
+  else
+  {
+    _stepInterval = fabs(1000000.0 / speed);
+    _direction = speed > 0.0;
+  }
+  _speed = speed;
+}
+
+void AccelStepper::setCurrentPosition(long position)
+{
+  _targetPos = _currentPos = position;
+  _n = 0;
+  _stepInterval = 0;
+  _speed = 0.0;
+}
+
+void AccelStepper::stop()
+{
+  if (_speed != 0.0)
+  {
+    long stepsToStop = (long)((_speed * _speed) / (2.0 * _acceleration)) + 1;
+    move(_speed > 0 ? stepsToStop : -stepsToStop);
+  }
+}
@@ -0,0 +1,56 @@
+#pragma once
+#include "Arduino.h"
+
+/*
+ * AccelStepper for host builds. Same interface subset and the same speed
+ * profile algorithm as the library (David Austin's stepper timing, as in
+ * AccelStepper 1.64). A step moves the position counter and pulses the
+ * step pin, which bound host::Pins can watch. Timing follows micros(), so
+ * a simulated machine steps on its own clock.
+ */
+class AccelStepper
+{
+public:
+  enum MotorInterfaceType
+  {
+    DRIVER = 1
+  };
+
+  AccelStepper(uint8_t interface = DRIVER, uint8_t pin1 = 2, uint8_t pin2 = 3);
+
+  void moveTo(long absolute);
+  void move(long relative);
+  bool run();
+  bool runSpeed();
+  bool runSpeedToPosition();
+  void setMaxSpeed(float speed);
+  float maxSpeed() { return _maxSpeed; }
+  void setAcceleration(float acceleration);
+  void setSpeed(float speed);
+  float speed() { return _speed; }
+  long distanceToGo() { return _targetPos - _currentPos; }
+  long targetPosition() { return _targetPos; }
+  long currentPosition() { return _currentPos; }
+  void setCurrentPosition(long position);
+  void stop();
+  bool isRunning() { return !(_speed == 0.0 && _targetPos == _currentPos); }
+  void setPinsInverted(bool, bool, bool) {}
+
+private:
+  void computeNewSpeed();
+
+  uint8_t _stepPin;
+  uint8_t _dirPin;
+  long _currentPos;
+  long _targetPos;
+  float _speed; // steps/s, negative is anticlockwise
+  float _maxSpeed;
+  float _acceleration;
+  unsigned long _stepInterval; // us, 0 = stopped
+  unsigned long _lastStepTime;
+  long _n;     // step counter of the speed ramp
+  float _c0;   // initial step interval
+  float _cn;   // last step interval
+  float _cmin; // interval at max speed
+  bool _direction; // true = clockwise (position increases)
+};
@@ -0,0 +1,184 @@
+#include "Arduino.h"
+#include <stdio.h>
+#include <time.h>
+#include <unistd.h>
+#include <poll.h>
+
+HardwareSerial Serial(0, 1);
+HardwareSerial Serial2(-1, -1);
+
+static bool virtualClock = false;
+static unsigned long virtualMicros = 0;
+static thread_local host::Clock *boundClock = NULL;
+static thread_local host::Pins *boundPins = NULL;
+static thread_local host::Eeprom *eeprom = NULL;
+
+static unsigned long wallMicros()
+{
+  static struct timespec origin = {0, 0};
+  struct timespec now;
+  clock_gettime(CLOCK_MONOTONIC, &now);
+  if (origin.tv_sec == 0 && origin.tv_nsec == 0)
+    origin = now;
+  return (unsigned long)((now.tv_sec - origin.tv_sec) * 1000000L + (now.tv_nsec - origin.tv_nsec) / 1000L);
+}
+
+namespace host
+{
+  void useVirtualClock(bool on)
+  {
+    virtualClock = on;
+  }
+
+  void setMicros(unsigned long us)
+  {
+    virtualMicros = us;
+  }
+
+  void advanceMicros(unsigned long us)
+  {
+    virtualMicros += us;
+  }
+
+  void bindClock(Clock *clock)
+  {
+    boundClock = clock;
+  }
+
+  void bindPins(Pins *pins)
+  {
+    boundPins = pins;
+  }
+
+  void bindEeprom(Eeprom *image)
+  {
+    eeprom = image;
+  }
+
+  Eeprom *boundEeprom()
+  {
+    return eeprom;
+  }
+}
+
+unsigned long micros()
+{
+  if (boundClock)
+    return boundClock->us;
+  return virtualClock ? virtualMicros : wallMicros();
+}
+
+unsigned long millis()
+{
+  return micros() / 1000UL;
+}
+
+void delay(unsigned long ms)
+{
+  delayMicroseconds(ms * 1000UL);
+}
+
+void delayMicroseconds(unsigned int us)
+{
+  if (boundClock)
+  {
+    boundClock->us += us;
+    return;
+  }
+  if (virtualClock)
+  {
+    virtualMicros += us;
+    return;
+  }
+  usleep(us);
+}
+
+void pinMode(uint8_t, uint8_t) {}
+void digitalWrite(uint8_t pin, uint8_t val)
+{
+  if (boundPins)
+    boundPins->write(pin, val);
+}
+
+int digitalRead(uint8_t pin) { return boundPins ? boundPins->read(pin) : LOW; }
+
+size_t Print::write(const uint8_t *buf, size_t n)
+{
+  size_t i = 0;
+  while (i < n && write(buf[i]))
+    i++;
+  return i;
+}
+
+size_t Print::print(long v, int base)
+{
+  char buf[40];
+  if (base == 16)
+    snprintf(buf, sizeof(buf), "%lX", v);
+  else
+    snprintf(buf, sizeof(buf), "%ld", v);
+  return write(buf);
+}
+
+size_t Print::print(unsigned long v, int base)
+{
+  char buf[40];
+  snprintf(buf, sizeof(buf), base == 16 ? "%lX" : "%lu", v);
+  return write(buf);
+}
+
+size_t Print::print(double v, int digits)
+{
+  char buf[48];
+  snprintf(buf, sizeof(buf), "%.*f", digits, v);
+  return write(buf);
+}
+
+int HardwareSerial::available()
+{
+  if (peek_ >= 0)
+    return 1;
+  if (in_ < 0)
+    return 0;
+  struct pollfd p = {in_, POLLIN, 0};
+  return (poll(&p, 1, 0) > 0 && (p.revents & POLLIN)) ? 1 : 0;
+}
+
+int HardwareSerial::read()
+{
+  if (peek_ >= 0)
+  {
+    int c = peek_;
+    peek_ = -1;
+    return c;
+  }
+  uint8_t c;
+  if (in_ < 0 || !available() || ::read(in_, &c, 1) != 1)
+    return -1;
+  return c;
+}
+
+int HardwareSerial::peek()
+{
+  if (peek_ < 0)
+    peek_ = read();
+  return peek_;
+}
+
+int HardwareSerial::availableForWrite()
+{
+  return 64;
+}
+
+size_t HardwareSerial::write(uint8_t c)
+{
+  return write(&c, 1);
+}
+
+size_t HardwareSerial::write(const uint8_t *buf, size_t n)
+{
+  if (out_ < 0)
+    return n; // unconnected port swallows output
+  ssize_t w = ::write(out_, buf, n);
+  return w < 0 ? 0 : (size_t)w;
+}
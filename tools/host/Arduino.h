@@ -0,0 +1,141 @@
+#pragma once
+
+/*
+ * Minimal Arduino core for building firmware modules into host tools
+ * (platform = native). Only what the firmware sources actually use; there
+ * is no String, so any String use in them fails the host builds.
+ *
+ * The clock can run on wall time or on a virtual time base that tools
+ * advance explicitly, which lets Interpolation be replayed offline. A
+ * thread can also bind its own Clock, so several simulated machines
+ * keep separate time while running in parallel, its own Pins to
+ * model hardware on the I/O pins, such as endstops, and its own Eeprom.
+ */
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <vector>
+
+#define PI 3.1415926535897932384626433832795
+
+// flash is ordinary memory here
+#define PROGMEM
+#define pgm_read_word(addr) (*(const uint16_t *)(addr))
+
+#define HIGH 0x1
+#define LOW 0x0
+#define INPUT 0x0
+#define OUTPUT 0x1
+#define INPUT_PULLUP 0x2
+
+typedef bool boolean;
+typedef uint8_t byte;
+
+unsigned long micros();
+unsigned long millis();
+void delay(unsigned long ms);
+void delayMicroseconds(unsigned int us);
+
+void pinMode(uint8_t pin, uint8_t mode);
+void digitalWrite(uint8_t pin, uint8_t val);
+int digitalRead(uint8_t pin);
+
+inline void noInterrupts() {}
+inline void interrupts() {}
+
+namespace host
+{
+  // Switches micros()/millis() to a clock that only moves when advanced.
+  void useVirtualClock(bool on);
+  void setMicros(unsigned long us);
+  void advanceMicros(unsigned long us);
+
+  // Time base of one simulated machine. While bound, micros(), millis()
+  // and delay() on the calling thread use it instead of the above.
+  struct Clock
+  {
+    Clock() : us(0) {}
+    unsigned long us;
+  };
+  void bindClock(Clock *clock); // NULL unbinds
+
+  // I/O pins of one simulated machine. While bound, digitalRead() and
+  // digitalWrite() on the calling thread go to it; unbound pins read LOW.
+  struct Pins
+  {
+    virtual ~Pins() {}
+    virtual int read(uint8_t pin) = 0;
+    virtual void write(uint8_t, uint8_t) {}
+  };
+  void bindPins(Pins *pins); // NULL unbinds
+
+  // Non-volatile memory of one simulated machine. While bound, EEPROM on
+  // the calling thread reads and writes it instead of the storage file.
+  struct Eeprom
+  {
+    Eeprom(size_t size) : bytes(size, 0xFF) {} // erased
+    std::vector<uint8_t> bytes;
+  };
+  void bindEeprom(Eeprom *eeprom); // NULL unbinds
+  Eeprom *boundEeprom();
+}
+
+class Print
+{
+public:
+  virtual ~Print() {}
+  virtual size_t write(uint8_t c) = 0;
+  virtual size_t write(const uint8_t *buf, size_t n);
+  size_t write(const char *s) { return write((const uint8_t *)s, strlen(s)); }
+
+  size_t print(const char *s) { return write(s); }
+  size_t print(char c) { return write((uint8_t)c); }
+  size_t print(int v, int base = 10) { return print((long)v, base); }
+  size_t print(unsigned int v, int base = 10) { return print((unsigned long)v, base); }
+  size_t print(long v, int base = 10);
+  size_t print(unsigned long v, int base = 10);
+  size_t print(double v, int digits = 2);
+
+  template <typename T>
+  size_t println(T v) { return print(v) + println(); }
+  template <typename T>
+  size_t println(T v, int fmt) { return print(v, fmt) + println(); }
+  size_t println() { return write((const uint8_t *)"\r\n", 2); }
+};
+
+class Stream : public Print
+{
+public:
+  virtual int available() = 0;
+  virtual int read() = 0;
+  virtual int peek() = 0;
+};
+
+// Serial port backed by a pair of file descriptors (stdin/stdout by default).
+class HardwareSerial : public Stream
+{
+public:
+  HardwareSerial(int inFd, int outFd) : in_(inFd), out_(outFd), peek_(-1) {}
+  void attach(int inFd, int outFd) { in_ = inFd; out_ = outFd; peek_ = -1; }
+  void begin(unsigned long) {}
+  void end() {}
+  int available() override;
+  int read() override;
+  int peek() override;
+  int availableForWrite();
+  void flush() {}
+  size_t write(uint8_t c) override;
+  size_t write(const uint8_t *buf, size_t n) override;
+  using Print::write;
+  operator bool() { return true; }
+
+private:
+  int in_, out_;
+  int peek_;
+};
+
+extern HardwareSerial Serial;
+extern HardwareSerial Serial2;
@@ -0,0 +1,61 @@
+#include "EEPROM.h"
+#include "config.h"
+#include <stdio.h>
+
+EEPROMClass EEPROM;
+
+static FILE *storageFile()
+{
+  static FILE *f = NULL;
+  if (f == NULL)
+  {
+    const char *path = getenv(STORAGE_ENV);
+    if (path == NULL || path[0] == 0)
+      path = STORAGE_FILE;
+    f = fopen(path, "r+b");
+    if (f == NULL)
+    {
+      // fresh file reads like an erased EEPROM
+      f = fopen(path, "w+b");
+      for (uint16_t i = 0; f != NULL && i < STORAGE_SIZE; i++)
+      {
+        fputc(0xFF, f);
+      }
+    }
+  }
+  return f;
+}
+
+uint8_t EEPROMClass::read(int idx)
+{
+  host::Eeprom *image = host::boundEeprom();
+  if (image != NULL)
+    return (idx >= 0 && (size_t)idx < image->bytes.size()) ? image->bytes[idx] : 0xFF;
+  FILE *f = storageFile();
+  if (f == NULL || idx < 0 || idx >= STORAGE_SIZE || fseek(f, idx, SEEK_SET) != 0)
+    return 0xFF;
+  int c = fgetc(f);
+  return (c == EOF) ? 0xFF : (uint8_t)c;
+}
+
+void EEPROMClass::write(int idx, uint8_t val)
+{
+  host::Eeprom *image = host::boundEeprom();
+  if (image != NULL)
+  {
+    if (idx >= 0 && (size_t)idx < image->bytes.size())
+      image->bytes[idx] = val;
+    return;
+  }
+  FILE *f = storageFile();
+  if (f == NULL || idx < 0 || idx >= STORAGE_SIZE || fseek(f, idx, SEEK_SET) != 0)
+    return;
+  fputc(val, f);
+  fflush(f);
+}
+
+uint16_t EEPROMClass::length()
+{
+  host::Eeprom *image = host::boundEeprom();
+  return (image != NULL) ? image->bytes.size() : STORAGE_SIZE;
+}
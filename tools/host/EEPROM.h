@@ -0,0 +1,17 @@
+#pragma once
+#include "Arduino.h"
+
+// EEPROM for host builds, with the library calls Storage uses. Bytes go to
+// the host::Eeprom image bound to the calling thread, one per simulated
+// arm, or else to a file that outlives the run: STORAGE_FILE (config.h) in
+// the working directory, unless the STORAGE_ENV variable names another.
+class EEPROMClass
+{
+public:
+  uint8_t read(int idx);
+  void write(int idx, uint8_t val);
+  void update(int idx, uint8_t val) { write(idx, val); }
+  uint16_t length();
+};
+
+extern EEPROMClass EEPROM;
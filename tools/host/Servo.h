@@ -0,0 +1,22 @@
+#pragma once
+#include "Arduino.h"
+
+// Servo for host builds: remembers the commanded angle, drives nothing.
+class Servo
+{
+public:
+  Servo() : pin_(-1), angle_(90) {}
+  uint8_t attach(int pin)
+  {
+    pin_ = pin;
+    return 0;
+  }
+  void detach() { pin_ = -1; }
+  bool attached() { return pin_ >= 0; }
+  void write(int angle) { angle_ = angle; }
+  int read() { return angle_; }
+
+private:
+  int pin_;
+  int angle_;
+};
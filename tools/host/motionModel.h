@@ -0,0 +1,88 @@
+#pragma once
+
+/*
+ * Motion model shared by the offline tools (cycleTime, gcodeCompiler,
+ * pickPlace): G-code line clean-up, joint targets in steps through the
+ * firmware's own RobotGeometry, and the time a stepper needs to travel.
+ * Header only, so the tools that don't link RobotGeometry still build.
+ */
+
+#include <Arduino.h>
+#include <string>
+#include "config.h"
+#include "robotGeometry.h"
+#include "kinematics.h"
+
+namespace motionModel
+{
+  // joint targets in whole steps, as the steppers get them
+  struct Steps
+  {
+    long higher, lower, rotate;
+  };
+
+  inline Steps solve(RobotGeometry &geometry, float x, float y, float z)
+  {
+    geometry.set(x, y, z);
+    Steps s;
+    s.higher = lroundf(geometry.getHighRad() * JointDrive::higherStepsPerRad);
+    s.lower = lroundf(geometry.getLowRad() * JointDrive::lowerStepsPerRad);
+    s.rotate = lroundf(geometry.getRotRad() * JointDrive::rotateStepsPerRad);
+    return s;
+  }
+
+  // strips ';' and '( )' comments plus surrounding whitespace
+  inline std::string clean(const std::string &line)
+  {
+    std::string out;
+    bool inParen = false;
+    for (size_t i = 0; i < line.size(); i++)
+    {
+      char c = line[i];
+      if (c == ';')
+        break;
+      if (c == '(')
+        inParen = true;
+      else if (c == ')')
+        inParen = false;
+      else if (!inParen)
+        out += c;
+    }
+    size_t a = out.find_first_not_of(" \t\r\n");
+    size_t b = out.find_last_not_of(" \t\r\n");
+    return (a == std::string::npos) ? std::string() : out.substr(a, b - a + 1);
+  }
+
+  // Steps are only issued once per loop() pass, so STEPPER_MAX_SPEED (or a
+  // lower top speed) comes down to whole passes per step (loopUs 0: no
+  // rounding). AccelStepper's own moves run at this; planned moves get
+  // CPU_STEP_HEADROOM of it.
+  inline float loopStepRate(float loopUs, float maxSpeed = STEPPER_MAX_SPEED)
+  {
+    if (loopUs <= 0)
+      return maxSpeed;
+    float interval = 1e6f / maxSpeed;
+    return 1e6f / (ceilf(interval / loopUs) * loopUs);
+  }
+
+  // A constant-rate run of steps meant to take seconds, as the loop delivers
+  // it: each step waits for the first pass at least one interval after the
+  // last, so the interval comes up to whole passes (loopUs 0: no rounding).
+  inline float stepRunTime(float seconds, long steps, float loopUs)
+  {
+    if (loopUs <= 0 || steps <= 0)
+      return seconds;
+    float passes = ceilf(seconds * 1e6f / (steps * loopUs) - 1e-3f);
+    return steps * passes * loopUs * 1e-6f;
+  }
+
+  // Shortest time for a stepper to travel this far from standstill to
+  // standstill, topping out at rate steps/s
+  inline float jointTime(float steps, float rate)
+  {
+    const float a = STEPPER_ACCEL;
+    if (steps >= rate * rate / a)
+      return steps / rate + rate / a; // reaches top speed
+    return 2.0f * sqrtf(steps / a);
+  }
+}
@@ -0,0 +1,62 @@
+#include "simEndstops.h"
+#include "config.h"
+#include "pinout.h"
+#include "kinematics.h"
+
+SimEndstops::SimEndstops(RampsStepper &higher, RampsStepper &lower, RampsStepper &rotate)
+{
+  Joint j[3] = {
+      {X_STEP_PIN, X_DIR_PIN, HIGHER_ENDSTOP_PIN, HOME_HIGHER_DIR, JointDrive::higherStepsPerRad, 0, HIGH_COUPLING,
+       higher.getPosition(), false},
+      {Y_STEP_PIN, Y_DIR_PIN, LOWER_ENDSTOP_PIN, HOME_LOWER_DIR, JointDrive::lowerStepsPerRad, 0, 0, lower.getPosition(), false},
+      {Z_STEP_PIN, Z_DIR_PIN, ROTATE_ENDSTOP_PIN, HOME_ROTATE_DIR, JointDrive::rotateStepsPerRad, 0, 0, rotate.getPosition(),
+       false}};
+  const float rad[3] = {(float)(HOME_HIGHER_DEG * PI / 180.0), (float)(HOME_LOWER_DEG * PI / 180.0),
+                        Kinematics::zToRot(HOME_Z_MM)};
+  for (uint8_t i = 0; i < 3; i++)
+  {
+    joints[i] = j[i];
+    joints[i].trip = lroundf(rad[i] * j[i].stepsPerRad);
+  }
+}
+
+void SimEndstops::powerOnAt(float x, float y, float z)
+{
+  bool elbow = false;
+  float rad[3];
+  Kinematics::inverse(x, y, z, elbow, rad[2], rad[1], rad[0]);
+  for (uint8_t i = 0; i < 3; i++)
+  {
+    joints[i].position = lroundf(rad[i] * joints[i].stepsPerRad);
+  }
+}
+
+int SimEndstops::read(uint8_t pin)
+{
+  for (uint8_t i = 0; i < 3; i++)
+  {
+    const Joint &j = joints[i];
+    if (j.switchPin == pin)
+    {
+      const Joint &lower = joints[1];
+      float lowerTurned = (float)(lower.position - lower.trip) / lower.stepsPerRad;
+      int32_t trip = j.trip + lroundf(j.coupling * lowerTurned * j.stepsPerRad);
+      bool pressed = (j.position - trip) * j.dir >= 0;
+      return pressed == (ENDSTOP_HIT == HIGH) ? HIGH : LOW;
+    }
+  }
+  return LOW;
+}
+
+// a rising edge on a step pin is one step in the direction pin's sense
+void SimEndstops::write(uint8_t pin, uint8_t val)
+{
+  for (uint8_t i = 0; i < 3; i++)
+  {
+    Joint &j = joints[i];
+    if (j.dirPin == pin)
+      j.forward = (val == HIGH);
+    else if (j.stepPin == pin && val == HIGH)
+      j.position += j.forward ? 1 : -1;
+  }
+}
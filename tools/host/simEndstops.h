@@ -0,0 +1,38 @@
+#pragma once
+#include <Arduino.h>
+#include "RampsStepper.h"
+
+// Endstops of one simulated arm, for the homing code to find. Each joint's
+// physical position follows the step and direction pins, so it doesn't
+// care what the firmware sets its step counters to. A switch is pressed
+// while its joint is at or past the switch position from config.h (HOME_*)
+// in the seek direction. The higher joint's switch sits on the upper arm:
+// it trips at HOME_HIGHER_DEG with the lower joint at HOME_LOWER_DEG, and
+// HIGH_COUPLING of whatever the lower joint turned from there on top. Bind
+// with host::bindPins().
+class SimEndstops : public host::Pins
+{
+public:
+  // Construct after setup(): the arm starts where the step counters say
+  SimEndstops(RampsStepper &higher, RampsStepper &lower, RampsStepper &rotate);
+
+  // The arm was switched on at this pose instead, which setup() can't know,
+  // so the step counters are off by the difference until G28.
+  void powerOnAt(float x, float y, float z);
+
+  int read(uint8_t pin) override;
+  void write(uint8_t pin, uint8_t val) override;
+
+private:
+  struct Joint
+  {
+    uint8_t stepPin, dirPin, switchPin;
+    int8_t dir; // seek direction
+    float stepsPerRad;
+    int32_t trip;     // physical steps where the switch closes
+    float coupling;   // of the lower joint's angle the trip point moves by
+    int32_t position; // physical steps
+    bool forward;     // direction pin
+  };
+  Joint joints[3];
+};
@@ -0,0 +1,96 @@
+#include "ikBatch.h"
+#include <thread>
+#include <vector>
+#include "kinematics.h"
+
+#define PARALLEL_MIN_POINTS 16384
+
+// Branch-free copy of Kinematics::inverse() so the compiler can vectorize
+// it (libmvec atan2f/acosf with -ffast-math). Points whose elbow branch
+// depends on the previous point take elbowDefault and are flagged.
+static void solveRange(const float *__restrict x, const float *__restrict y, const float *__restrict z,
+                       size_t begin, size_t end,
+                       float *__restrict rot, float *__restrict low, float *__restrict high,
+                       uint8_t *__restrict flags, bool elbowDefault)
+{
+  typedef Kinematics K;
+#pragma omp simd
+  for (size_t i = begin; i < end; i++)
+  {
+    float xi = x[i];
+    float yi = y[i];
+    float distSq = xi * xi + yi * yi;
+    float dist = sqrtf(distSq);
+    bool clamped = dist > K::maxReach;
+    dist = clamped ? K::maxReach - 1e-3f : dist;
+    distSq = clamped ? dist * dist : distSq;
+    bool singular = dist < 1e-6f;
+    float safeDist = singular ? 1.0f : dist;
+
+    bool down = (xi > 0 && yi < K::maxReach) || xi > K::parkedX;
+    bool up = xi < 0 && yi < K::maxReach;
+    bool inherited = !down && !up;
+    bool elbow = up || (inherited && elbowDefault);
+
+    float xr = elbow ? -xi : xi;
+    float d1 = atan2f(yi, xr);
+    float d2 = acosf(K::clampUnit((distSq + K::lenSqDiff) * K::inv2L1 / safeDist));
+    float l = d1 + d2 - (float)(PI * 0.5);
+    float h = acosf(K::clampUnit((K::lenSqSum - distSq) * K::inv2L1L2)) - (float)PI;
+    l = elbow ? -l : l;
+    h = elbow ? -h : h;
+    h += ScaraParams::coupling * l;
+
+    rot[i] = K::rotPerMm * z[i];
+    low[i] = singular ? 0.0f : l;
+    high[i] = singular ? (float)-PI : h;
+    flags[i] = (clamped ? IK_CLAMPED : 0) | (elbow ? IK_ELBOW_UP : 0) |
+               (inherited ? IK_ELBOW_INHERITED : 0) | (singular ? IK_SINGULAR : 0);
+  }
+}
+
+void ikSolveBatch(const float *x, const float *y, const float *z, size_t n,
+                  float *rot, float *low, float *high, uint8_t *flags,
+                  bool elbowStart, unsigned threads)
+{
+  if (threads == 0)
+    threads = std::thread::hardware_concurrency();
+  if (threads == 0 || n < PARALLEL_MIN_POINTS)
+    threads = 1;
+
+  if (threads == 1)
+  {
+    solveRange(x, y, z, 0, n, rot, low, high, flags, elbowStart);
+  }
+  else
+  {
+    std::vector<std::thread> pool;
+    size_t chunk = (n + threads - 1) / threads;
+    for (size_t begin = 0; begin < n; begin += chunk)
+    {
+      size_t end = (begin + chunk < n) ? begin + chunk : n;
+      pool.push_back(std::thread(solveRange, x, y, z, begin, end, rot, low, high, flags, elbowStart));
+    }
+    for (size_t i = 0; i < pool.size(); i++)
+      pool[i].join();
+  }
+
+  // The elbow branch is stateful where the heuristic is undecided (x == 0).
+  // Walk the batch in order and redo the few points that inherited the
+  // other branch, exactly as a sequence of RobotGeometry::set() calls would.
+  bool elbow = elbowStart;
+  for (size_t i = 0; i < n; i++)
+  {
+    if (!(flags[i] & IK_ELBOW_INHERITED))
+    {
+      elbow = flags[i] & IK_ELBOW_UP;
+      continue;
+    }
+    if (elbow != elbowStart)
+    {
+      bool e = elbow;
+      Kinematics::inverse(x[i], y[i], z[i], e, rot[i], low[i], high[i]);
+      flags[i] = (flags[i] & ~IK_ELBOW_UP) | (elbow ? IK_ELBOW_UP : 0);
+    }
+  }
+}
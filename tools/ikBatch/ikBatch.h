@@ -0,0 +1,27 @@
+#pragma once
+#include <stddef.h>
+#include <stdint.h>
+
+/*
+ * Batch inverse kinematics for host-side tools (reachability maps,
+ * trajectory and program checks). Structure-of-arrays in and out, no
+ * RobotGeometry object, no serial output.
+ *
+ * Results match calling RobotGeometry::set() on the points in order,
+ * starting with elbow = elbowStart, to within float rounding of the
+ * vectorized math library.
+ */
+
+enum IkFlags
+{
+  IK_CLAMPED = 0x01,         // out of reach, solved for the nearest reachable radius
+  IK_ELBOW_UP = 0x02,        // mirrored (elbow-up) solution
+  IK_ELBOW_INHERITED = 0x04, // branch carried over from the previous point
+  IK_SINGULAR = 0x08         // at the origin, fixed folded pose
+};
+
+// Solves n points. threads = 0 picks the hardware concurrency; small
+// batches always run on the calling thread.
+void ikSolveBatch(const float *x, const float *y, const float *z, size_t n,
+                  float *rot, float *low, float *high, uint8_t *flags,
+                  bool elbowStart = false, unsigned threads = 0);
@@ -0,0 +1,100 @@
+/*
+ * Command-line front end for the batch IK solver.
+ *
+ *   ikBatch [-t threads] [points.csv]   x,y,z per line in, rot,low,high,flags out
+ *   ikBatch --bench n [-t threads]      random workspace points: throughput
+ *                                       and deviation from Kinematics::inverse()
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <chrono>
+#include <random>
+#include <vector>
+#include "ikBatch.h"
+#include "kinematics.h"
+
+static int bench(size_t n, unsigned threads)
+{
+  std::vector<float> x(n), y(n), z(n), rot(n), low(n), high(n);
+  std::vector<uint8_t> flags(n);
+  std::mt19937 rng(1);
+  std::uniform_real_distribution<float> r(-Kinematics::maxReach - 10, Kinematics::maxReach + 10);
+  std::uniform_real_distribution<float> h(Z_MIN, Z_MAX);
+  for (size_t i = 0; i < n; i++)
+  {
+    x[i] = r(rng);
+    y[i] = r(rng);
+    z[i] = h(rng);
+  }
+  x[n / 2] = 0; // exercise the inherited elbow branch
+
+  auto t0 = std::chrono::steady_clock::now();
+  ikSolveBatch(&x[0], &y[0], &z[0], n, &rot[0], &low[0], &high[0], &flags[0], false, threads);
+  auto t1 = std::chrono::steady_clock::now();
+
+  bool elbow = false;
+  double maxDiff = 0;
+  for (size_t i = 0; i < n; i++)
+  {
+    float r0, l0, h0;
+    Kinematics::inverse(x[i], y[i], z[i], elbow, r0, l0, h0);
+    double d = fabs(r0 - rot[i]) + fabs(l0 - low[i]) + fabs(h0 - high[i]);
+    if (d > maxDiff)
+      maxDiff = d;
+  }
+  auto t2 = std::chrono::steady_clock::now();
+
+  double batchS = std::chrono::duration<double>(t1 - t0).count();
+  double scalarS = std::chrono::duration<double>(t2 - t1).count();
+  printf("%zu points: batch %.1f Mpts/s, scalar %.1f Mpts/s, max deviation %.2e rad\n",
+         n, n / batchS * 1e-6, n / scalarS * 1e-6, maxDiff);
+  return 0;
+}
+
+int main(int argc, char **argv)
+{
+  unsigned threads = 0;
+  size_t benchN = 0;
+  const char *path = NULL;
+  for (int i = 1; i < argc; i++)
+  {
+    if (!strcmp(argv[i], "-t") && i + 1 < argc)
+      threads = atoi(argv[++i]);
+    else if (!strcmp(argv[i], "--bench") && i + 1 < argc)
+      benchN = strtoul(argv[++i], NULL, 10);
+    else
+      path = argv[i];
+  }
+  if (benchN)
+    return bench(benchN, threads);
+
+  FILE *in = path ? fopen(path, "r") : stdin;
+  if (in == NULL)
+  {
+    perror(path);
+    return 1;
+  }
+  std::vector<float> x, y, z;
+  float a, b, c;
+  char line[256];
+  while (fgets(line, sizeof(line), in))
+  {
+    if (sscanf(line, "%f,%f,%f", &a, &b, &c) == 3)
+    {
+      x.push_back(a);
+      y.push_back(b);
+      z.push_back(c);
+    }
+  }
+  size_t n = x.size();
+  if (n == 0)
+    return 0;
+  std::vector<float> rot(n), low(n), high(n);
+  std::vector<uint8_t> flags(n);
+  ikSolveBatch(&x[0], &y[0], &z[0], n, &rot[0], &low[0], &high[0], &flags[0], false, threads);
+  for (size_t i = 0; i < n; i++)
+    printf("%.6f,%.6f,%.6f,%u\n", rot[i], low[i], high[i], flags[i]);
+  return 0;
+}
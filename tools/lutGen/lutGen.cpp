@@ -0,0 +1,303 @@
+/*
+ * Table generator for the KINEMATICS_LUT backend.
+ *
+ * The SCARA inverse splits into a part that only depends on the distance
+ * from the base (the elbow angle and the shoulder's law-of-cosines
+ * correction, both functions of x^2 + y^2) and the bearing atan2(y, x).
+ * So instead of one 2D grid of joint solutions, which would not fit in
+ * flash at step-level accuracy, the backend keeps two 1D tables over r^2
+ * and one atan table over [0, 1] for the octant-reduced bearing, all read
+ * with linear interpolation. No sqrt or trig is left on the hot path,
+ * one divide for the bearing ratio.
+ *
+ * The tables cover R_MIN .. maxReach - margin. Toward full reach the elbow
+ * angle goes like sqrt(reach - r) and no grid keeps up, so points beyond
+ * the margin, like those inside R_MIN, fall back to the exact solver.
+ *
+ * Resolution is picked for a target error on the final joint angles
+ * (coupling included), by default a quarter step of the finest joint:
+ * the bearing table first with a quarter of the budget, then the radial
+ * tables for the rest, both checked end to end against double-precision
+ * IK on a dense polar grid the same way the firmware will read them.
+ *
+ *   lutGen [-e max_err_rad] [-m margin_mm] [-o dir]
+ *       writes ikLut.h and ikLut.cpp to dir (default src) and prints the
+ *       node counts, flash cost and worst error found
+ */
+
+#include <Arduino.h>
+#include <stdio.h>
+#include <math.h>
+#include <string>
+#include <vector>
+#include "config.h" // not kinematics.h, which needs ikLut.h once the backend is picked
+
+// uint16 nodes, each table scaled to its own range
+struct Table
+{
+  std::vector<uint16_t> nodes;
+  double radPerCount;
+
+  void fill(const std::vector<double> &rad)
+  {
+    double top = 0;
+    for (size_t i = 0; i < rad.size(); i++)
+      top = fmax(top, rad[i]);
+    radPerCount = top / 65535.0;
+    nodes.resize(rad.size());
+    for (size_t i = 0; i < rad.size(); i++)
+      nodes[i] = (uint16_t)lround(rad[i] / radPerCount);
+  }
+};
+
+struct Tables
+{
+  float r2Min, r2Max, r2InvStep;
+  Table shoulder, elbow, bearing;
+};
+
+static double clampUnit(double x)
+{
+  return fmax(-1.0, fmin(1.0, x));
+}
+
+// the firmware's read, in float
+static float lerp(const Table &tab, float f)
+{
+  int i = (int)f;
+  if (i > (int)tab.nodes.size() - 2)
+    i = tab.nodes.size() - 2;
+  float t = f - i;
+  float a = tab.nodes[i];
+  float b = tab.nodes[i + 1];
+  return (a + (b - a) * t) * (float)tab.radPerCount;
+}
+
+static float bearing(const Tables &lut, float x, float y)
+{
+  float ax = fabsf(x), ay = fabsf(y);
+  bool steep = ay > ax;
+  float t = steep ? ax / ay : ay / ax;
+  float a = lerp(lut.bearing, t * (lut.bearing.nodes.size() - 1));
+  if (steep)
+    a = (float)(PI * 0.5) - a;
+  if (x < 0)
+    a = (float)PI - a;
+  return (y < 0) ? -a : a;
+}
+
+// elbow-down branch, before coupling
+static void exact(double x, double y, double &low, double &high)
+{
+  double distSq = x * x + y * y, dist = sqrt(distSq);
+  low = atan2(y, x) + acos((distSq + L1 * L1 - L2 * L2) / (2 * L1 * dist)) - PI * 0.5;
+  high = acos((L1 * L1 + L2 * L2 - distSq) / (2 * L1 * L2)) - PI;
+}
+
+static void fromTables(const Tables &lut, float x, float y, float &low, float &high)
+{
+  float distSq = x * x + y * y;
+  float f = (distSq - lut.r2Min) * lut.r2InvStep;
+  low = bearing(lut, x, y) + lerp(lut.shoulder, f) - (float)(PI * 0.5);
+  high = -lerp(lut.elbow, f);
+}
+
+static void fillBearing(Tables &lut, int n)
+{
+  std::vector<double> rad(n);
+  for (int i = 0; i < n; i++)
+    rad[i] = atan((double)i / (n - 1));
+  lut.bearing.fill(rad);
+}
+
+static void fillRadial(Tables &lut, int n)
+{
+  double r2Min = lut.r2Min, step = ((double)lut.r2Max - r2Min) / (n - 1);
+  lut.r2InvStep = (float)(1.0 / step);
+  std::vector<double> shoulder(n), elbow(n);
+  for (int i = 0; i < n; i++)
+  {
+    double distSq = r2Min + i * step, dist = sqrt(distSq);
+    shoulder[i] = acos(clampUnit((distSq + L1 * L1 - L2 * L2) / (2 * L1 * dist)));
+    elbow[i] = PI - acos(clampUnit((L1 * L1 + L2 * L2 - distSq) / (2 * L1 * L2)));
+  }
+  lut.shoulder.fill(shoulder);
+  lut.elbow.fill(elbow);
+}
+
+static double bearingError(const Tables &lut)
+{
+  double worst = 0;
+  int samples = (lut.bearing.nodes.size() - 1) * 16;
+  for (int i = 0; i <= samples; i++)
+  {
+    double t = (double)i / samples;
+    worst = fmax(worst, fabs(lerp(lut.bearing, t * (lut.bearing.nodes.size() - 1)) - atan(t)));
+  }
+  return worst;
+}
+
+// worst error on the final joint angles, coupling included, both branches
+// being mirror images of each other
+static double jointError(const Tables &lut)
+{
+  const int bearings = 97;
+  int radii = (lut.shoulder.nodes.size() - 1) * 8;
+  double rMin = sqrt(lut.r2Min), rMax = sqrt(lut.r2Max);
+  double worst = 0;
+  for (int i = 0; i <= radii; i++)
+  {
+    double r = rMin + (rMax - rMin) * i / radii;
+    if (r * r >= lut.r2Max)
+      r = sqrt(lut.r2Max) - 1e-4;
+    for (int j = 0; j < bearings; j++)
+    {
+      double a = -PI + 2 * PI * (j + 0.5) / bearings;
+      double x = r * cos(a), y = r * sin(a), low, high;
+      float lowT, highT;
+      exact(x, y, low, high);
+      fromTables(lut, (float)x, (float)y, lowT, highT);
+      double dLow = remainder(lowT - low, 2 * PI);
+      double dHigh = remainder(highT - high, 2 * PI);
+      worst = fmax(worst, fmax(fabs(dLow), fabs(dHigh + HIGH_COUPLING * dLow)));
+    }
+  }
+  return worst;
+}
+
+// fewest nodes in [lo, hi] whose error is within target, -1 if none
+template <class Fill, class Err>
+static int smallest(int lo, int hi, double target, Fill fill, Err err)
+{
+  fill(hi);
+  if (err() > target)
+    return -1;
+  while (lo < hi)
+  {
+    int mid = (lo + hi) / 2;
+    fill(mid);
+    if (err() <= target)
+      hi = mid;
+    else
+      lo = mid + 1;
+  }
+  fill(hi);
+  return hi;
+}
+
+static void writeTable(FILE *out, const char *name, const Table &tab)
+{
+  fprintf(out, "\nconst uint16_t %s[%u] PROGMEM = {", name, (unsigned)tab.nodes.size());
+  for (size_t i = 0; i < tab.nodes.size(); i++)
+    fprintf(out, "%s%u,", (i % 12) ? " " : "\n  ", tab.nodes[i]);
+  fprintf(out, "\n};\n");
+}
+
+static bool write(const std::string &dir, const Tables &lut, double target, double margin, double err)
+{
+  std::string hPath = dir + "/ikLut.h", cppPath = dir + "/ikLut.cpp";
+  FILE *h = fopen(hPath.c_str(), "w");
+  if (!h)
+  {
+    perror(hPath.c_str());
+    return false;
+  }
+  fprintf(h, "#pragma once\n#include <Arduino.h>\n\n");
+  fprintf(h, "// Generated by tools/lutGen for L1 %g, L2 %g, R_MIN %g: do not edit.\n", L1, L2, R_MIN);
+  fprintf(h, "// Target %.2e rad, worst found %.2e rad, reach margin %g mm.\n\n", target, err, margin);
+  fprintf(h, "#define IK_LUT_L1 %.1f\n#define IK_LUT_L2 %.1f\n", L1, L2);
+  fprintf(h, "#define IK_LUT_R2_MIN %#.9gf\n", lut.r2Min);
+  fprintf(h, "#define IK_LUT_R2_MAX %#.9gf\n", lut.r2Max);
+  fprintf(h, "#define IK_LUT_R2_INV_STEP %#.9gf\n", lut.r2InvStep);
+  fprintf(h, "#define IK_LUT_RADIAL_N %u\n", (unsigned)lut.shoulder.nodes.size());
+  fprintf(h, "#define IK_LUT_BEARING_N %u\n", (unsigned)lut.bearing.nodes.size());
+  fprintf(h, "#define IK_LUT_SHOULDER_RAD %#.9gf // per count\n", lut.shoulder.radPerCount);
+  fprintf(h, "#define IK_LUT_ELBOW_RAD %#.9gf\n", lut.elbow.radPerCount);
+  fprintf(h, "#define IK_LUT_BEARING_RAD %#.9gf\n\n", lut.bearing.radPerCount);
+  fprintf(h, "extern const uint16_t ikLutShoulder[IK_LUT_RADIAL_N]; // acos term of the shoulder over r^2\n");
+  fprintf(h, "extern const uint16_t ikLutElbow[IK_LUT_RADIAL_N];    // minus the elbow angle over r^2\n");
+  fprintf(h, "extern const uint16_t ikLutBearing[IK_LUT_BEARING_N]; // atan over [0, 1]\n");
+  fclose(h);
+
+  FILE *c = fopen(cppPath.c_str(), "w");
+  if (!c)
+  {
+    perror(cppPath.c_str());
+    return false;
+  }
+  fprintf(c, "// Generated by tools/lutGen: do not edit.\n#include \"config.h\"\n\n");
+  fprintf(c, "#if defined(KINEMATICS_LUT)\n#include \"ikLut.h\"\n");
+  writeTable(c, "ikLutShoulder", lut.shoulder);
+  writeTable(c, "ikLutElbow", lut.elbow);
+  writeTable(c, "ikLutBearing", lut.bearing);
+  fprintf(c, "\n#endif\n");
+  fclose(c);
+  return true;
+}
+
+static void usage()
+{
+  fprintf(stderr, "usage: lutGen [-e max_err_rad] [-m margin_mm] [-o dir]\n");
+  exit(2);
+}
+
+int main(int argc, char **argv)
+{
+  double stepRad = 2 * PI / (STEPS_PER_REV * fmax(HIGHER_GEAR_RATIO, LOWER_GEAR_RATIO));
+  double target = 0.25 * stepRad;
+  double margin = 1.0;
+  std::string dir = "src";
+  int arg = 1;
+  while (arg < argc && argv[arg][0] == '-')
+  {
+    std::string opt = argv[arg++];
+    if (arg >= argc)
+      usage();
+    if (opt == "-e")
+      target = atof(argv[arg++]);
+    else if (opt == "-m")
+      margin = atof(argv[arg++]);
+    else if (opt == "-o")
+      dir = argv[arg++];
+    else
+      usage();
+  }
+  if (arg != argc || target <= 0 || margin <= 0)
+    usage();
+
+  Tables lut;
+  double rMax = (L1 + L2) - margin;
+  lut.r2Min = (float)(R_MIN * R_MIN);
+  lut.r2Max = (float)(rMax * rMax);
+
+  int bearingN = smallest(
+      2, 4096, 0.25 * target, [&](int n) { fillBearing(lut, n); },
+      [&]() { return bearingError(lut); });
+  if (bearingN < 0)
+  {
+    fprintf(stderr, "lutGen: no bearing table within 4096 nodes reaches %.2e rad\n", 0.25 * target);
+    return 1;
+  }
+  int radialN = smallest(
+      2, 16384, target, [&](int n) { fillRadial(lut, n); },
+      [&]() { return jointError(lut); });
+  if (radialN < 0)
+  {
+    fprintf(stderr, "lutGen: no radial table within 16384 nodes reaches %.2e rad, widen the margin (-m)\n",
+            target);
+    return 1;
+  }
+
+  double err = jointError(lut);
+  if (!write(dir, lut, target, margin, err))
+    return 1;
+
+  unsigned flash = 2 * (2 * radialN + bearingN);
+  printf("target     %.2e rad (%.2f steps)\n", target, target / stepRad);
+  printf("worst      %.2e rad (%.2f steps)\n", err, err / stepRad);
+  printf("covers     r %.1f .. %.1f mm, exact solver outside\n", (double)R_MIN, rMax);
+  printf("radial     %d nodes, %.2f mm^2 apart\n", radialN, 1.0 / lut.r2InvStep);
+  printf("bearing    %d nodes\n", bearingN);
+  printf("flash      %u bytes\n", flash);
+  return 0;
+}
@@ -0,0 +1,641 @@
+/*
+ * Pick-and-place sequence optimizer.
+ *
+ * Reorders a list of pick/place tasks to cut the arm's travel time between
+ * them, keeping any "after" constraints, and writes the result as G-code.
+ *
+ * Every station is solved through the firmware's RobotGeometry at a common
+ * travel height, and travel runs in joint space as G6 segments (plus a G92
+ * to keep the Cartesian position in sync, as gcodeCompiler does), so a leg
+ * takes as long as its slowest joint needs at STEPPER_MAX_SPEED and
+ * STEPPER_ACCEL, rounded to whole loop passes (-l) and less CPU_STEP_HEADROOM
+ * like cycleTime; the G0 drops and lifts in the estimate get no headroom. A change
+ * of elbow branch is already in that joint travel; it also swings the arm
+ * through full reach, so it costs an extra penalty (-f) on top. A straight
+ * joint-space leg never comes closer to the base than its ends, so the
+ * R_MIN keep-out holds without checking the path.
+ *
+ * The search is a multi-start local search, one start per thread: the
+ * listed order, nearest-first, then randomized nearest-first. Each start
+ * runs 2-opt (segment reversal) and or-opt (moving runs of up to three
+ * tasks) to a local optimum, then iterated local search with double-bridge
+ * kicks. Moves that would put a task before one it has to follow are
+ * skipped. The best tour over all threads wins; with the same thread count
+ * and iterations the result is the same every run.
+ *
+ * Task file, one task per line, '#' or ';' starts a comment:
+ *
+ *   id  pick_x pick_y pick_z  place_x place_y place_z  [after id[,id...]]
+ *
+ * Output per task: G6 to above the pick, G0 down, M3, G0 up, G6 to above
+ * the place, G0 down, M5, G0 up. It starts with G28, G6 needs a homed arm.
+ *
+ *   pickPlace [-j threads] [-i iterations] [-z travel_mm] [-f flip_s]
+ *             [-l loop_us] [-r] [-k] tasks.txt [output.gcode]
+ *       -r returns to the start pose at the end, -k keeps the listed order
+ *       (for comparison). Travel times, the cycle estimate and the task
+ *       order go to stderr; the firmware takes no comments, so the G-code
+ *       has none.
+ */
+
+#include <Arduino.h>
+#include <stdio.h>
+#include <string.h>
+#include <algorithm>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+#include "config.h"
+#include "robotGeometry.h"
+#include "softLimits.h"
+#include "kinematics.h"
+#include "motionModel.h"
+
+#define TRAVEL_CLEARANCE_MM 30.0f // default travel height above the highest station
+#define OR_OPT_MAX 3              // longest run of tasks or-opt moves
+#define MIN_GAIN_S 1e-4f          // smaller improvements are rounding noise
+
+struct Pose
+{
+  float x, y, z;
+  long higher, lower, rotate; // steps
+  bool elbow;
+};
+
+struct Task
+{
+  std::string id;
+  float pickZ, placeZ;
+  Pose pick, place; // at travel height
+  std::vector<int> after;
+};
+
+static float maxStepRate = CPU_STEP_HEADROOM * STEPPER_MAX_SPEED; // steps/s after loop rounding
+static float rapidStepRate = STEPPER_MAX_SPEED;                    // G0 Z drops and lifts, no headroom
+static float flipPenalty = 0.5f;
+
+static float jointTime(float steps)
+{
+  return motionModel::jointTime(steps, maxStepRate);
+}
+
+static float rapidTime(float steps)
+{
+  return motionModel::jointTime(steps, rapidStepRate);
+}
+
+static Pose solve(RobotGeometry &geometry, float x, float y, float z)
+{
+  geometry.setElbow(false); // same branch for a point whatever came before
+  motionModel::Steps s = motionModel::solve(geometry, x, y, z);
+  Pose p = {x, y, z, s.higher, s.lower, s.rotate, geometry.getElbow()};
+  return p;
+}
+
+// duration of a G6 leg between two poses
+static float legTime(const Pose &a, const Pose &b)
+{
+  return fmaxf(jointTime(labs(b.higher - a.higher)),
+               fmaxf(jointTime(labs(b.lower - a.lower)), jointTime(labs(b.rotate - a.rotate))));
+}
+
+static float legCost(const Pose &a, const Pose &b)
+{
+  return legTime(a, b) + ((a.elbow != b.elbow) ? flipPenalty : 0.0f);
+}
+
+// Travel cost between tasks, node 0 is the start pose
+class Problem
+{
+public:
+  Problem(const std::vector<Task> &tasks, const Pose &start, bool returnHome)
+      : n(tasks.size() + 1), cost(n * n, 0.0f), before(n)
+  {
+    for (int i = 0; i < n; i++)
+    {
+      const Pose &from = i ? tasks[i - 1].place : start;
+      for (int j = 1; j < n; j++)
+        cost[i * n + j] = (i == j) ? 0.0f : legCost(from, tasks[j - 1].pick);
+      cost[i * n] = (returnHome && i) ? legCost(from, start) : 0.0f;
+    }
+    for (int j = 1; j < n; j++)
+      for (size_t k = 0; k < tasks[j - 1].after.size(); k++)
+        before[j].push_back(tasks[j - 1].after[k] + 1);
+  }
+
+  float at(int i, int j) const { return cost[i * n + j]; }
+
+  // order holds the tasks' nodes, 1..n-1
+  float tour(const std::vector<int> &order) const
+  {
+    float sum = 0;
+    int prev = 0;
+    for (size_t k = 0; k < order.size(); k++)
+    {
+      sum += at(prev, order[k]);
+      prev = order[k];
+    }
+    return sum + at(prev, 0);
+  }
+
+  const int n;
+  std::vector<float> cost;
+  std::vector<std::vector<int> > before; // nodes that must come earlier
+};
+
+// One local search run. The tour is kept as p[0] = start, p[1..n-1] the
+// tasks, p[n] = start again, with prefix sums of the edge costs walked
+// forward and backward so a 2-opt reversal is priced in O(1).
+class Search
+{
+public:
+  Search(const Problem &problem, unsigned seed) : pr(problem), rng(seed) {}
+
+  void run(std::vector<int> order, long iterations)
+  {
+    load(order);
+    descend();
+    std::vector<int> best = p;
+    double bestCost = total();
+    for (long it = 0; it < iterations; it++)
+    {
+      if (!kick())
+        break;
+      descend();
+      if (total() < bestCost - MIN_GAIN_S)
+      {
+        best = p;
+        bestCost = total();
+      }
+      else
+        loadTour(best);
+    }
+    loadTour(best);
+  }
+
+  std::vector<int> order() const { return std::vector<int>(p.begin() + 1, p.end() - 1); }
+  double total() const { return fwd[pr.n]; }
+
+private:
+  void load(const std::vector<int> &order)
+  {
+    p.assign(1, 0);
+    p.insert(p.end(), order.begin(), order.end());
+    p.push_back(0);
+    update();
+  }
+
+  void loadTour(const std::vector<int> &tour)
+  {
+    p = tour;
+    update();
+  }
+
+  void update()
+  {
+    int n = pr.n;
+    pos.resize(n);
+    fwd.assign(n + 1, 0.0);
+    bwd.assign(n + 1, 0.0);
+    for (int k = 0; k < n; k++)
+    {
+      fwd[k + 1] = fwd[k] + pr.at(p[k], p[k + 1]);
+      bwd[k + 1] = bwd[k] + pr.at(p[k + 1], p[k]);
+    }
+    for (int k = 1; k < n; k++)
+      pos[p[k]] = k;
+  }
+
+  // any task at lo..hi that has to follow one at from..to
+  bool follows(int lo, int hi, int from, int to) const
+  {
+    for (int k = lo; k <= hi; k++)
+      for (size_t b = 0; b < pr.before[p[k]].size(); b++)
+      {
+        int q = pos[pr.before[p[k]][b]];
+        if (q >= from && q <= to)
+          return true;
+      }
+    return false;
+  }
+
+  bool twoOpt()
+  {
+    int last = pr.n - 1;
+    for (int i = 1; i < last; i++)
+      for (int k = i + 1; k <= last; k++)
+      {
+        double delta = pr.at(p[i - 1], p[k]) + pr.at(p[i], p[k + 1]) + (bwd[k] - bwd[i]) -
+                      pr.at(p[i - 1], p[i]) - pr.at(p[k], p[k + 1]) - (fwd[k] - fwd[i]);
+        if (delta < -MIN_GAIN_S && !follows(i, k, i, k))
+        {
+          std::reverse(p.begin() + i, p.begin() + k + 1);
+          update();
+          return true;
+        }
+      }
+    return false;
+  }
+
+  bool orOpt()
+  {
+    int last = pr.n - 1;
+    for (int len = 1; len <= OR_OPT_MAX; len++)
+      for (int i = 1; i + len - 1 <= last; i++)
+      {
+        int e = i + len - 1;
+        float removed = pr.at(p[i - 1], p[i]) + pr.at(p[e], p[e + 1]) - pr.at(p[i - 1], p[e + 1]);
+        for (int j = 0; j <= last; j++)
+        {
+          if (j >= i - 1 && j <= e)
+            continue; // inserting after p[j] would leave the run in place
+          float added = pr.at(p[j], p[i]) + pr.at(p[e], p[j + 1]) - pr.at(p[j], p[j + 1]);
+          if (added - removed >= -MIN_GAIN_S)
+            continue;
+          if (j > e ? follows(e + 1, j, i, e) : follows(i, e, j + 1, i - 1))
+            continue;
+          std::vector<int> run(p.begin() + i, p.begin() + e + 1);
+          if (j > e)
+          {
+            std::copy(p.begin() + e + 1, p.begin() + j + 1, p.begin() + i);
+            std::copy(run.begin(), run.end(), p.begin() + j - len + 1);
+          }
+          else
+          {
+            std::copy_backward(p.begin() + j + 1, p.begin() + i, p.begin() + e + 1);
+            std::copy(run.begin(), run.end(), p.begin() + j + 1);
+          }
+          update();
+          return true;
+        }
+      }
+    return false;
+  }
+
+  void descend()
+  {
+    bool improved = true;
+    while (improved)
+      improved = twoOpt() || orOpt();
+  }
+
+  // double bridge A B C D -> A C B D, for a few random tries at a legal one
+  bool kick()
+  {
+    int m = pr.n - 1;
+    if (m < 4)
+      return false;
+    std::uniform_int_distribution<int> cut(1, m + 1);
+    for (int tries = 0; tries < 32; tries++)
+    {
+      int c[3] = {cut(rng), cut(rng), cut(rng)};
+      std::sort(c, c + 3);
+      if (c[0] == c[1] || c[1] == c[2])
+        continue;
+      // B = c0..c1-1, C = c1..c2-1; C moves ahead of B
+      if (follows(c[1], c[2] - 1, c[0], c[1] - 1))
+        continue;
+      std::rotate(p.begin() + c[0], p.begin() + c[1], p.begin() + c[2]);
+      update();
+      return true;
+    }
+    return false;
+  }
+
+  const Problem &pr;
+  std::mt19937 rng;
+  std::vector<int> p, pos;
+  std::vector<double> fwd, bwd;
+};
+
+// Nearest-first among the tasks whose predecessors are done; with spread > 1
+// picks at random among that many nearest
+static std::vector<int> greedy(const Problem &pr, std::mt19937 &rng, int spread)
+{
+  std::vector<int> order;
+  std::vector<bool> done(pr.n, false);
+  int at = 0;
+  while ((int)order.size() < pr.n - 1)
+  {
+    std::vector<std::pair<float, int> > ready;
+    for (int j = 1; j < pr.n; j++)
+    {
+      bool ok = !done[j];
+      for (size_t b = 0; ok && b < pr.before[j].size(); b++)
+        ok = done[pr.before[j][b]];
+      if (ok)
+        ready.push_back(std::make_pair(pr.at(at, j), j));
+    }
+    std::sort(ready.begin(), ready.end());
+    int pick = std::uniform_int_distribution<int>(0, std::min(spread, (int)ready.size()) - 1)(rng);
+    at = ready[pick].second;
+    done[at] = true;
+    order.push_back(at);
+  }
+  return order;
+}
+
+// Listed order, with tasks held back until their predecessors are placed.
+// False if the constraints have a cycle.
+static bool listedOrder(const Problem &pr, std::vector<int> &order)
+{
+  std::vector<bool> done(pr.n, false);
+  order.clear();
+  while ((int)order.size() < pr.n - 1)
+  {
+    size_t placed = order.size();
+    for (int j = 1; j < pr.n; j++)
+    {
+      bool ok = !done[j];
+      for (size_t b = 0; ok && b < pr.before[j].size(); b++)
+        ok = done[pr.before[j][b]];
+      if (ok)
+      {
+        done[j] = true;
+        order.push_back(j);
+        break;
+      }
+    }
+    if (order.size() == placed)
+      return false;
+  }
+  return true;
+}
+
+static bool readTasks(const char *path, std::vector<Task> &tasks)
+{
+  FILE *in = fopen(path, "r");
+  if (in == NULL)
+  {
+    perror(path);
+    return false;
+  }
+  std::vector<std::vector<std::string> > afterIds;
+  char buf[512];
+  long lineNo = 0;
+  bool ok = true;
+  while (ok && fgets(buf, sizeof(buf), in))
+  {
+    lineNo++;
+    buf[strcspn(buf, "#;\r\n")] = 0;
+    char id[64], after[256] = "";
+    Task t;
+    float px, py, qx, qy;
+    int got = sscanf(buf, "%63s %f %f %f %f %f %f after %255s", id, &px, &py, &t.pickZ,
+                     &qx, &qy, &t.placeZ, after);
+    if (got <= 0)
+      continue;
+    if (got < 7)
+    {
+      fprintf(stderr, "%s:%ld: expected id, pick x y z, place x y z [after id,...]\n", path, lineNo);
+      ok = false;
+      break;
+    }
+    t.id = id;
+    t.pick.x = px;
+    t.pick.y = py;
+    t.place.x = qx;
+    t.place.y = qy;
+    std::vector<std::string> ids;
+    for (char *s = strtok(after, ","); s; s = strtok(NULL, ","))
+      ids.push_back(s);
+    for (size_t k = 0; k < tasks.size(); k++)
+      if (tasks[k].id == t.id)
+      {
+        fprintf(stderr, "%s:%ld: task '%s' listed twice\n", path, lineNo, id);
+        ok = false;
+      }
+    tasks.push_back(t);
+    afterIds.push_back(ids);
+  }
+  fclose(in);
+
+  for (size_t i = 0; ok && i < tasks.size(); i++)
+    for (size_t k = 0; k < afterIds[i].size(); k++)
+    {
+      size_t j = 0;
+      while (j < tasks.size() && tasks[j].id != afterIds[i][k])
+        j++;
+      if (j == tasks.size() || j == i)
+      {
+        fprintf(stderr, "%s: task '%s' can't follow '%s'\n", path, tasks[i].id.c_str(), afterIds[i][k].c_str());
+        ok = false;
+        break;
+      }
+      tasks[i].after.push_back(j);
+    }
+  return ok;
+}
+
+static bool station(const Task &t, const char *what, float x, float y, float z)
+{
+  uint8_t error = SoftLimits::checkPoint(x, y, z);
+  if (error == LIMIT_OK)
+    return true;
+  fprintf(stderr, "task '%s': %s at %.1f %.1f %.1f: %s\n", t.id.c_str(), what, x, y, z,
+          SoftLimits::describe(error));
+  return false;
+}
+
+static void writeLeg(FILE *out, const Pose &from, const Pose &to)
+{
+  fprintf(out, "G6 X%ld Y%ld Z%ld T%.3f\n", to.higher, to.lower, to.rotate, (double)legTime(from, to));
+  fprintf(out, "G92 X%.4f Y%.4f Z%.4f\n", (double)to.x, (double)to.y, (double)to.z);
+}
+
+static void writeProgram(FILE *out, const std::vector<Task> &tasks, const std::vector<int> &order,
+                         const Pose &start, bool returnHome)
+{
+  fprintf(out, "G28\nG0 Z%.4f\n", (double)start.z);
+  const Pose *at = &start;
+  for (size_t k = 0; k < order.size(); k++)
+  {
+    const Task &t = tasks[order[k] - 1];
+    writeLeg(out, *at, t.pick);
+    fprintf(out, "G0 Z%.4f\nM3\nG0 Z%.4f\n", (double)t.pickZ, (double)t.pick.z);
+    writeLeg(out, t.pick, t.place);
+    fprintf(out, "G0 Z%.4f\nM5\nG0 Z%.4f\n", (double)t.placeZ, (double)t.place.z);
+    at = &t.place;
+  }
+  if (returnHome)
+    writeLeg(out, *at, start);
+}
+
+// real travel time between tasks, without the flip penalty
+static float travelTime(const std::vector<Task> &tasks, const std::vector<int> &order, const Pose &start,
+                        bool returnHome)
+{
+  float sum = 0;
+  const Pose *at = &start;
+  for (size_t k = 0; k < order.size(); k++)
+  {
+    sum += legTime(*at, tasks[order[k] - 1].pick);
+    at = &tasks[order[k] - 1].place;
+  }
+  return returnHome ? sum + legTime(*at, start) : sum;
+}
+
+static int elbowChanges(const std::vector<Task> &tasks, const std::vector<int> &order, const Pose &start)
+{
+  int changes = 0;
+  bool elbow = start.elbow;
+  for (size_t k = 0; k < order.size(); k++)
+  {
+    const Task &t = tasks[order[k] - 1];
+    changes += (t.pick.elbow != elbow) + (t.place.elbow != t.pick.elbow);
+    elbow = t.place.elbow;
+  }
+  return changes;
+}
+
+static void usage()
+{
+  fprintf(stderr, "usage: pickPlace [-j threads] [-i iterations] [-z travel_mm] [-f flip_s]\n"
+                  "                 [-l loop_us] [-r] [-k] tasks.txt [output.gcode]\n");
+}
+
+int main(int argc, char **argv)
+{
+  unsigned threads = std::thread::hardware_concurrency();
+  long iterations = 2000;
+  float travelZ = NAN, loopUs = 100;
+  bool returnHome = false, keep = false;
+  int arg = 1;
+  while (arg < argc && argv[arg][0] == '-')
+  {
+    std::string opt = argv[arg++];
+    if (opt == "-r")
+      returnHome = true;
+    else if (opt == "-k")
+      keep = true;
+    else if (arg >= argc)
+      arg = argc; // option without its value
+    else if (opt == "-j")
+      threads = atoi(argv[arg++]);
+    else if (opt == "-i")
+      iterations = atol(argv[arg++]);
+    else if (opt == "-z")
+      travelZ = atof(argv[arg++]);
+    else if (opt == "-f")
+      flipPenalty = atof(argv[arg++]);
+    else if (opt == "-l")
+      loopUs = atof(argv[arg++]);
+    else
+      arg = argc; // unknown option
+  }
+  if (arg >= argc || arg + 2 < argc || loopUs < 0 || iterations < 0 || flipPenalty < 0)
+  {
+    usage();
+    return 2;
+  }
+  if (threads == 0)
+    threads = 1;
+  rapidStepRate = motionModel::loopStepRate(loopUs);
+  maxStepRate = CPU_STEP_HEADROOM * rapidStepRate;
+
+  std::vector<Task> tasks;
+  if (!readTasks(argv[arg], tasks))
+    return 1;
+  if (tasks.empty())
+  {
+    fprintf(stderr, "%s: no tasks\n", argv[arg]);
+    return 1;
+  }
+  if (isnan(travelZ))
+  {
+    travelZ = -INFINITY;
+    for (size_t i = 0; i < tasks.size(); i++)
+      travelZ = fmaxf(travelZ, fmaxf(tasks[i].pickZ, tasks[i].placeZ) + TRAVEL_CLEARANCE_MM);
+    travelZ = fminf(travelZ, Z_MAX);
+  }
+
+  RobotGeometry geometry;
+  Pose start = solve(geometry, INITIAL_X, INITIAL_Y, travelZ); // where G28 parks, at travel height
+  bool ok = true;
+  if (SoftLimits::checkPoint(INITIAL_X, INITIAL_Y, travelZ) != LIMIT_OK)
+  {
+    fprintf(stderr, "travel height %.1f: %s\n", (double)travelZ,
+            SoftLimits::describe(SoftLimits::checkPoint(INITIAL_X, INITIAL_Y, travelZ)));
+    ok = false;
+  }
+  for (size_t i = 0; i < tasks.size(); i++)
+  {
+    Task &t = tasks[i];
+    ok = station(t, "pick", t.pick.x, t.pick.y, t.pickZ) && ok;
+    ok = station(t, "place", t.place.x, t.place.y, t.placeZ) && ok;
+    ok = station(t, "pick, travel height", t.pick.x, t.pick.y, travelZ) && ok;
+    ok = station(t, "place, travel height", t.place.x, t.place.y, travelZ) && ok;
+    t.pick = solve(geometry, t.pick.x, t.pick.y, travelZ);
+    t.place = solve(geometry, t.place.x, t.place.y, travelZ);
+  }
+  if (!ok)
+    return 1;
+
+  Problem problem(tasks, start, returnHome);
+  std::vector<int> listed;
+  if (!listedOrder(problem, listed))
+  {
+    fprintf(stderr, "%s: the after constraints form a cycle\n", argv[arg]);
+    return 1;
+  }
+
+  std::vector<int> best = listed;
+  if (!keep)
+  {
+    std::vector<std::vector<int> > results(threads);
+    std::vector<std::thread> pool;
+    for (unsigned t = 0; t < threads; t++)
+      pool.push_back(std::thread([&, t]() {
+        std::mt19937 rng(t + 1);
+        std::vector<int> init = (t == 0) ? listed : greedy(problem, rng, (t == 1) ? 1 : 3);
+        Search search(problem, t + 1);
+        search.run(init, iterations);
+        results[t] = search.order();
+      }));
+    for (size_t t = 0; t < pool.size(); t++)
+      pool[t].join();
+    for (unsigned t = 0; t < threads; t++)
+      if (problem.tour(results[t]) < problem.tour(best) - MIN_GAIN_S)
+        best = results[t];
+  }
+
+  FILE *out = stdout;
+  if (arg + 1 < argc)
+  {
+    out = fopen(argv[arg + 1], "w");
+    if (out == NULL)
+    {
+      perror(argv[arg + 1]);
+      return 1;
+    }
+  }
+  writeProgram(out, tasks, best, start, returnHome);
+  if (out != stdout)
+    fclose(out);
+
+  // the task-internal legs, drops, lifts and grips don't depend on the order
+  Pose parked = solve(geometry, INITIAL_X, INITIAL_Y, INITIAL_Z);
+  float rapid = rapidTime(labs(start.rotate - parked.rotate)), fixed = 0;
+  for (size_t i = 0; i < tasks.size(); i++)
+  {
+    const Task &t = tasks[i];
+    fixed += legTime(t.pick, t.place) + 2 * SERVO_MOVE_MS * 1e-3f;
+    fixed += 2 * rapidTime(labs(solve(geometry, t.pick.x, t.pick.y, t.pickZ).rotate - t.pick.rotate));
+    fixed += 2 * rapidTime(labs(solve(geometry, t.place.x, t.place.y, t.placeZ).rotate - t.place.rotate));
+  }
+  float before = travelTime(tasks, listed, start, returnHome);
+  float after = travelTime(tasks, best, start, returnHome);
+  fprintf(stderr, "%u tasks, travel at Z %.1f\n", (unsigned)tasks.size(), (double)travelZ);
+  fprintf(stderr, "listed order: travel %.3f s, %d elbow changes\n", (double)before,
+          elbowChanges(tasks, listed, start));
+  if (!keep)
+    fprintf(stderr, "optimized:    travel %.3f s, %d elbow changes (%u threads x %ld iterations)\n",
+            (double)after, elbowChanges(tasks, best, start), threads, iterations);
+  fprintf(stderr, "cycle %.3f s after G28\n", (double)(rapid + fixed + after));
+  fprintf(stderr, "order:");
+  for (size_t k = 0; k < best.size(); k++)
+    fprintf(stderr, " %s", tasks[best[k] - 1].id.c_str());
+  fprintf(stderr, "\n");
+  return 0;
+}
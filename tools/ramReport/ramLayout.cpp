@@ -0,0 +1,27 @@
+/*
+ * Never linked: ramReport.py compiles this for the target with the
+ * firmware's flags and reads each object's size back from the symbol
+ * table, so the report shows the members of RobotArm, which the firmware
+ * image only knows as one symbol. Keep in step with robotArm.h.
+ */
+
+#include "robotArm.h"
+
+#define RAM_SIZE(name, type)                \
+  extern "C" char ram_##name[sizeof(type)]; \
+  __attribute__((used)) char ram_##name[sizeof(type)];
+
+typedef Queue<Cmd, QUEUE_SIZE> CmdQueue;
+
+RAM_SIZE(RobotArm, RobotArm)
+RAM_SIZE(RobotGeometry, RobotGeometry)
+RAM_SIZE(Interpolation, Interpolation)
+RAM_SIZE(Queue, CmdQueue)
+RAM_SIZE(Command, Command)
+RAM_SIZE(ProgramStore, ProgramStore)
+RAM_SIZE(Telemetry, Telemetry)
+RAM_SIZE(SyncEvents, SyncEvents)
+RAM_SIZE(Logger, Logger)
+RAM_SIZE(CpuBudget, CpuBudget)
+RAM_SIZE(Homing, Homing)
+RAM_SIZE(Cmd, Cmd)
@@ -0,0 +1,121 @@
+# PlatformIO extra script for env:heapFree: adds the "ramreport" target,
+# which breaks the firmware's static RAM down per subsystem.
+#
+#   pio run -e heapFree -t ramreport
+#
+# Globals come from the image's symbol table. RobotArm is one symbol there,
+# so ramLayout.cpp is compiled with the same flags and its sizes give the
+# members. What is left between the static data and the top of RAM is the
+# stack's; how much of it the stack really used, M122 measures on the arm.
+Import("env")
+import os
+import re
+import subprocess
+
+RAM_SIZE = 8192  # ATmega2560
+
+# image symbols -> subsystem, first match wins
+GROUPS = [
+    ("robotArm", r"^robotArm$"),
+    ("serial tx buffer", r"^serialTx$"),
+    ("serial ports (core)", r"^Serial\d?$|^_?rx_buffer|^_?tx_buffer"),
+    ("steppers", r"^stepper(Higher|Lower|Rotate)$"),
+    ("gripper", r"^servo_gripper$|^servo_motor$|^servos$|^ServoCount$"),
+    ("storage", r"^storage|^EEPROM"),
+    ("timers (core)", r"^timer0_"),
+]
+
+# members of RobotArm, as named in robotArm.h
+MEMBERS = [
+    ("command (line + rx buffer)", "Command"),
+    ("queue (QUEUE_SIZE commands)", "Queue"),
+    ("interpolator", "Interpolation"),
+    ("geometry", "RobotGeometry"),
+    ("homing", "Homing"),
+    ("cpu budget", "CpuBudget"),
+    ("sync events", "SyncEvents"),
+    ("telemetry", "Telemetry"),
+    ("program store", "ProgramStore"),
+    ("logger", "Logger"),
+]
+
+
+def tool(name):
+    cxx = env.subst("$CXX")
+    return cxx[: -len("g++")] + name if cxx.endswith("g++") else name
+
+
+def symbols(path, types):
+    out = subprocess.check_output([tool("nm"), "-S", "-C", path]).decode()
+    sizes = {}
+    for line in out.splitlines():
+        parts = line.split(None, 3)
+        if len(parts) == 4 and parts[2] in types:
+            sizes[parts[3]] = int(parts[1], 16)
+    return sizes
+
+
+def sections(path):
+    out = subprocess.check_output([tool("size"), "-A", path]).decode()
+    found = {}
+    for line in out.splitlines():
+        parts = line.split()
+        if len(parts) >= 2 and parts[0] in (".data", ".bss", ".noinit"):
+            found[parts[0]] = int(parts[1])
+    return found
+
+
+def report(target, source, env):
+    build = env.subst("$BUILD_DIR")
+    elf = os.path.join(build, env.subst("${PROGNAME}.elf"))
+    layout = symbols(os.path.join(build, "ramLayout.o"), "bB")
+    image = symbols(elf, "bBdD")
+    sec = sections(elf)
+
+    lines = []
+    static = sum(sec.values())
+    lines.append("static RAM: %d of %d bytes (.data %d, .bss %d), %d left for the stack"
+                 % (static, RAM_SIZE, sec.get(".data", 0), sec.get(".bss", 0), RAM_SIZE - static))
+    lines.append("")
+
+    rest = dict(image)
+    for group, pattern in GROUPS:
+        names = [n for n in list(rest) if re.search(pattern, n)]
+        if not names:
+            continue
+        lines.append("%6d  %s" % (sum(rest[n] for n in names), group))
+        if group == "robotArm":
+            members = 0
+            for label, key in MEMBERS:
+                size = layout.get("ram_" + key, 0)
+                members += size
+                lines.append("%14d  %s" % (size, label))
+            lines.append("%14d  own state and references"
+                         % (layout.get("ram_RobotArm", 0) - members))
+        for n in names:
+            del rest[n]
+    other = sum(rest.values())
+    lines.append("%6d  other symbols (%d)" % (other, len(rest)))
+    lines.append("%6d  string literals and unnamed data" % (static - sum(image.values())))
+    lines.append("")
+    lines.append("largest other symbols:")
+    for n, size in sorted(rest.items(), key=lambda kv: -kv[1])[:10]:
+        lines.append("%6d  %s" % (size, n))
+
+    text = "\n".join(lines) + "\n"
+    print(text)
+    with open(os.path.join(build, "ramReport.txt"), "w") as f:
+        f.write(text)
+
+
+env.AddCustomTarget(
+    name="ramreport",
+    dependencies="$BUILD_DIR/${PROGNAME}.elf",
+    actions=[
+        "$CXX -c -o $BUILD_DIR/ramLayout.o $CXXFLAGS $CCFLAGS $_CCCOMCOM -I$PROJECT_SRC_DIR "
+        "$PROJECT_DIR/tools/ramReport/ramLayout.cpp",
+        report,
+    ],
+    title="RAM report",
+    description="Static RAM per subsystem, written to ramReport.txt in the build dir",
+)
@@ -0,0 +1,11 @@
+G92 X314 Y0 Z210
+M17
+G1 X200 Y100 Z150 F3000
+G1 X150 Y-150 Z100 F3000
+G1 Z50
+G4 T0.2
+G1 X250 Y0 Z150 F6000
+G1 X-100 Y200 Z120 F3000
+G1 X200 Y100 Z150
+M114
+M18
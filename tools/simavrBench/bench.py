@@ -0,0 +1,18 @@
+# PlatformIO extra script for env:simavrBench: adds the "bench" target,
+# which builds the simavr harness and runs the firmware image in it.
+Import("env")
+import os
+
+harness = os.path.join(env.subst("$PROJECT_BUILD_DIR"), "simavrBenchHost", "program")
+script = os.path.join(env.subst("$PROJECT_DIR"), "tools", "simavrBench", "bench.gcode")
+
+env.AddCustomTarget(
+    name="bench",
+    dependencies="$BUILD_DIR/${PROGNAME}.elf",
+    actions=[
+        "pio run -e simavrBenchHost",
+        '"%s" "$BUILD_DIR/${PROGNAME}.elf" "%s"' % (harness, script),
+    ],
+    title="simavr benchmark",
+    description="Run the firmware in simavr and report cycle counts",
+)
@@ -0,0 +1,252 @@
+/*
+ * Runs the real ATmega2560 firmware image in simavr and reports cycle counts.
+ *
+ * The firmware is built with BENCH_MARKERS (env:simavrBench), which makes it
+ * write a marker id to GPIOR0 at each loop() stage boundary, around every
+ * calculateGrad() call and around every parsed line. Those writes are caught
+ * here and timestamped with the simulator's cycle counter. The G-code script
+ * is fed into UART0 as a host would send it.
+ *
+ * usage: simavrBench [-t max_seconds] [-v] firmware.elf script.gcode
+ *   or:  pio run -e simavrBench -t bench
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <string>
+#include <simavr/sim_avr.h>
+#include <simavr/sim_elf.h>
+#include <simavr/sim_io.h>
+#include <simavr/sim_irq.h>
+#include <simavr/avr_uart.h>
+#include "bench.h"
+
+#define GPIOR0_ADDR 0x3E // data-space address of GPIOR0 (I/O 0x1E)
+#define CPU_HZ 16000000UL
+
+struct Stat
+{
+  const char *name;
+  unsigned long count;
+  uint64_t sum, min, max;
+
+  void add(uint64_t cycles)
+  {
+    if (count == 0 || cycles < min)
+      min = cycles;
+    if (cycles > max)
+      max = cycles;
+    sum += cycles;
+    count++;
+  }
+
+  void print() const
+  {
+    if (count == 0)
+    {
+      printf("%-22s %10s\n", name, "-");
+      return;
+    }
+    double mean = (double)sum / count;
+    printf("%-22s %10lu %10llu %10.0f %10llu %9.1f\n", name, count,
+           (unsigned long long)min, mean, (unsigned long long)max, mean * 1e6 / CPU_HZ);
+  }
+};
+
+enum
+{
+  STAT_STEPPERS,
+  STAT_IO,
+  STAT_IDLE,
+  STAT_MOTION,
+  STAT_CORE,
+  STAT_LOOP,
+  STAT_LOOP_MOVING,
+  STAT_IK,
+  STAT_PARSE,
+  STAT_COUNT
+};
+
+static Stat stats[STAT_COUNT] = {
+    {"stage: steppers", 0, 0, 0, 0},
+    {"stage: serial/status", 0, 0, 0, 0},
+    {"stage: parse/execute", 0, 0, 0, 0},
+    {"stage: interp/IK", 0, 0, 0, 0},
+    {"stage: core overhead", 0, 0, 0, 0},
+    {"loop()", 0, 0, 0, 0},
+    {"loop() while moving", 0, 0, 0, 0},
+    {"calculateGrad()", 0, 0, 0, 0},
+    {"parsed line", 0, 0, 0, 0},
+};
+
+static uint64_t seen[16];      // cycle of the latest occurrence of each marker
+static bool loopHadIk = false;
+static uint64_t lastIkCycle = 0;
+
+static void onMarker(avr_t *avr, avr_io_addr_t, uint8_t id, void *)
+{
+  uint64_t now = avr->cycle;
+  switch (id)
+  {
+  case BENCH_LOOP_START:
+    if (seen[BENCH_MOTION_DONE] > seen[BENCH_LOOP_START])
+      stats[STAT_CORE].add(now - seen[BENCH_MOTION_DONE]);
+    if (seen[BENCH_LOOP_START])
+    {
+      stats[STAT_LOOP].add(now - seen[BENCH_LOOP_START]);
+      if (loopHadIk)
+        stats[STAT_LOOP_MOVING].add(now - seen[BENCH_LOOP_START]);
+    }
+    loopHadIk = false;
+    break;
+  case BENCH_STEPPERS_DONE:
+    stats[STAT_STEPPERS].add(now - seen[BENCH_LOOP_START]);
+    break;
+  case BENCH_IO_DONE:
+    stats[STAT_IO].add(now - seen[BENCH_STEPPERS_DONE]);
+    break;
+  case BENCH_IDLE_DONE:
+    stats[STAT_IDLE].add(now - seen[BENCH_IO_DONE]);
+    break;
+  case BENCH_MOTION_DONE:
+    stats[STAT_MOTION].add(now - seen[BENCH_IDLE_DONE]);
+    break;
+  case BENCH_IK_END:
+    stats[STAT_IK].add(now - seen[BENCH_IK_START]);
+    loopHadIk = true;
+    lastIkCycle = now;
+    break;
+  case BENCH_PARSE_END:
+    stats[STAT_PARSE].add(now - seen[BENCH_PARSE_START]);
+    break;
+  }
+  if (id < 16)
+    seen[id] = now;
+}
+
+static bool xon = true;
+static bool verbose = false;
+
+static void onXon(avr_irq_t *, uint32_t, void *)
+{
+  xon = true;
+}
+
+static void onXoff(avr_irq_t *, uint32_t, void *)
+{
+  xon = false;
+}
+
+static void onUartOut(avr_irq_t *, uint32_t value, void *)
+{
+  if (verbose)
+    fputc((char)value, stderr);
+}
+
+static std::string readScript(const char *path)
+{
+  std::string out;
+  FILE *f = fopen(path, "r");
+  if (f == NULL)
+  {
+    perror(path);
+    exit(1);
+  }
+  int c;
+  while ((c = fgetc(f)) != EOF)
+    out += (c == '\n') ? '\r' : (char)c; // the firmware ends lines on CR
+  fclose(f);
+  return out;
+}
+
+int main(int argc, char **argv)
+{
+  double maxSeconds = 120;
+  int arg = 1;
+  while (arg < argc && argv[arg][0] == '-')
+  {
+    if (!strcmp(argv[arg], "-t") && arg + 1 < argc)
+      maxSeconds = atof(argv[++arg]);
+    else if (!strcmp(argv[arg], "-v"))
+      verbose = true;
+    arg++;
+  }
+  if (arg + 2 != argc)
+  {
+    fprintf(stderr, "usage: simavrBench [-t max_seconds] [-v] firmware.elf script.gcode\n");
+    return 2;
+  }
+
+  elf_firmware_t fw;
+  memset(&fw, 0, sizeof(fw));
+  if (elf_read_firmware(argv[arg], &fw) != 0)
+  {
+    fprintf(stderr, "cannot read %s\n", argv[arg]);
+    return 1;
+  }
+  std::string script = readScript(argv[arg + 1]);
+
+  avr_t *avr = avr_make_mcu_by_name("atmega2560");
+  if (avr == NULL)
+  {
+    fprintf(stderr, "simavr has no atmega2560 core\n");
+    return 1;
+  }
+  avr_init(avr);
+  fw.frequency = CPU_HZ;
+  avr_load_firmware(avr, &fw);
+
+  avr_register_io_write(avr, GPIOR0_ADDR, onMarker, NULL);
+
+  uint32_t flags = 0;
+  avr_ioctl(avr, AVR_IOCTL_UART_GET_FLAGS('0'), &flags);
+  flags &= ~AVR_UART_FLAG_STDIO;
+  avr_ioctl(avr, AVR_IOCTL_UART_SET_FLAGS('0'), &flags);
+  avr_irq_t *uartIn = avr_io_getirq(avr, AVR_IOCTL_UART_GETIRQ('0'), UART_IRQ_INPUT);
+  avr_irq_register_notify(avr_io_getirq(avr, AVR_IOCTL_UART_GETIRQ('0'), UART_IRQ_OUTPUT), onUartOut, NULL);
+  avr_irq_register_notify(avr_io_getirq(avr, AVR_IOCTL_UART_GETIRQ('0'), UART_IRQ_OUT_XON), onXon, NULL);
+  avr_irq_register_notify(avr_io_getirq(avr, AVR_IOCTL_UART_GETIRQ('0'), UART_IRQ_OUT_XOFF), onXoff, NULL);
+
+  // let setup() finish before sending anything
+  const uint64_t startCycles = CPU_HZ / 2;
+  const uint64_t maxCycles = (uint64_t)(maxSeconds * CPU_HZ);
+  const uint64_t settleCycles = CPU_HZ; // idle time that ends the run once the script is sent
+  size_t sent = 0;
+  uint64_t scriptDone = 0;
+  int state = cpu_Running;
+  while (state != cpu_Done && state != cpu_Crashed && avr->cycle < maxCycles)
+  {
+    state = avr_run(avr);
+    if (avr->cycle < startCycles)
+      continue;
+    if (sent < script.size())
+    {
+      if (xon)
+        avr_raise_irq(uartIn, (uint8_t)script[sent++]);
+      if (sent == script.size())
+        scriptDone = avr->cycle;
+    }
+    else if (avr->cycle - scriptDone > settleCycles && avr->cycle - lastIkCycle > settleCycles)
+    {
+      break;
+    }
+  }
+  if (state == cpu_Crashed)
+    fprintf(stderr, "firmware crashed at cycle %llu\n", (unsigned long long)avr->cycle);
+
+  printf("\nsimulated %.2f s, %zu/%zu script bytes sent\n\n", (double)avr->cycle / CPU_HZ, sent, script.size());
+  printf("%-22s %10s %10s %10s %10s %9s\n", "cycles", "count", "min", "mean", "max", "mean us");
+  for (int i = 0; i < STAT_COUNT; i++)
+    stats[i].print();
+
+  const Stat &moving = stats[STAT_LOOP_MOVING];
+  if (moving.count)
+  {
+    // every loop() pass can issue at most one step per joint
+    double mean = (double)moving.sum / moving.count;
+    printf("\nmax step rate per joint while moving: %.0f steps/s sustained, %.0f steps/s worst case\n",
+           CPU_HZ / mean, (double)CPU_HZ / moving.max);
+  }
+  return state == cpu_Crashed ? 1 : 0;
+}
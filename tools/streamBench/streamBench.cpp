@@ -0,0 +1,404 @@
+/*
+ * Streaming throughput benchmark.
+ *
+ * Runs the firmware (RobotArm on the host Arduino shim) on the slave end
+ * of a pseudo-terminal and a sender on the master end, in real time. The
+ * sender memory-maps the G-code file and streams it the way a host should:
+ * the window is the firmware's free input buffer, read from the Bf: field
+ * of '?' status replies, minus whatever was sent after the query. Bytes go
+ * out no faster than the simulated baud rate allows (10 bits per byte).
+ *
+ * Blank and comment-only lines are not sent, and every line sent is
+ * expected to become one queued command, so avoid commands the firmware
+ * does not queue (M28/M29 recording) and moves the soft limits reject.
+ *
+ * One CSV line per baud rate goes to stdout:
+ *   baud,lines,elapsed_s,cmds_per_s,starve_events,starve_s,lat_avg_ms,lat_p99_ms,lat_max_ms,faults
+ * elapsed_s runs from the first byte sent to the last command started.
+ * Starvation is the firmware having nothing to run or start while the
+ * program is not done yet. Latency runs from the last byte of a line
+ * leaving the sender to the firmware starting the command.
+ *
+ * usage: streamBench [-b baud,baud,...] [-l loop_us] [-t max_s] program.gcode
+ */
+
+#include <Arduino.h>
+#include <stdio.h>
+#include <string.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <termios.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <algorithm>
+#include <atomic>
+#include <string>
+#include <thread>
+#include <vector>
+#include "config.h"
+#include "pinout.h"
+#include "kinematics.h"
+#include "robotArm.h"
+#include "simEndstops.h"
+
+#define QUERY_GAP_US 2000       // least time between '?' polls while the window is shut
+#define QUERY_TIMEOUT_US 200000 // poll again if a reply got lost
+
+struct Line
+{
+  const char *text;
+  size_t len; // without the line end
+};
+
+struct Result
+{
+  unsigned long baud;
+  size_t lines;
+  double elapsedS;
+  long starveEvents;
+  double starveS;
+  double latAvgMs, latP99Ms, latMaxMs;
+  long faults;
+  bool finished;
+};
+
+// Splits the mapped file into the lines worth sending
+static void splitLines(const char *data, size_t size, std::vector<Line> &lines)
+{
+  size_t pos = 0;
+  while (pos < size)
+  {
+    const char *eol = (const char *)memchr(data + pos, '\n', size - pos);
+    size_t end = eol ? (size_t)(eol - data) : size;
+    size_t a = pos, b = end;
+    while (a < b && (data[a] == ' ' || data[a] == '\t'))
+      a++;
+    while (b > a && (data[b - 1] == '\r' || data[b - 1] == ' ' || data[b - 1] == '\t'))
+      b--;
+    if (a < b && data[a] != ';' && data[a] != '(')
+    {
+      Line l = {data + a, b - a};
+      lines.push_back(l);
+    }
+    pos = end + 1;
+  }
+}
+
+// Raw pty pair, master non-blocking
+static bool openPty(int &master, int &slave)
+{
+  master = posix_openpt(O_RDWR | O_NOCTTY);
+  if (master < 0 || grantpt(master) < 0 || unlockpt(master) < 0)
+  {
+    perror("pty");
+    return false;
+  }
+  slave = open(ptsname(master), O_RDWR | O_NOCTTY);
+  if (slave < 0)
+  {
+    perror(ptsname(master));
+    close(master);
+    return false;
+  }
+  struct termios t;
+  tcgetattr(slave, &t);
+  cfmakeraw(&t);
+  tcsetattr(slave, TCSANOW, &t);
+  fcntl(master, F_SETFL, fcntl(master, F_GETFL) | O_NONBLOCK);
+  return true;
+}
+
+static bool runBaud(const std::vector<Line> &lines, unsigned long baud, unsigned long loopUs,
+                    double maxS, Result &r)
+{
+  int master, slave;
+  if (!openPty(master, slave))
+    return false;
+
+  const size_t n = lines.size();
+  std::vector<unsigned long> sentUs(n), startUs(n);
+  std::atomic<uint32_t> executed(0);
+  std::atomic<bool> idle(false), stop(false);
+  long starveEvents = 0;
+  unsigned long starveUs = 0;
+
+  std::thread firmware([&]() {
+    RampsStepper higher(X_STEP_PIN, X_DIR_PIN, X_ENABLE_PIN, INVERSE_X_STEPPER, JointDrive::higherStepsPerRad);
+    RampsStepper lower(Y_STEP_PIN, Y_DIR_PIN, Y_ENABLE_PIN, INVERSE_Y_STEPPER, JointDrive::lowerStepsPerRad);
+    RampsStepper rotate(Z_STEP_PIN, Z_DIR_PIN, Z_ENABLE_PIN, INVERSE_Z_STEPPER, JointDrive::rotateStepsPerRad);
+    Servo_Gripper gripper(SERVO_PIN, SERVO_GRIP_DEGREE, SERVO_UNGRIP_DEGREE);
+    Equipment led(LED_PIN);
+    HardwareSerial port(slave, slave);
+    SerialTx tx(port);
+    RobotArm arm(higher, lower, rotate, gripper, led, tx, &port);
+    arm.setup();
+    SimEndstops endstops(higher, lower, rotate);
+    endstops.powerOnAt(INITIAL_X, INITIAL_Y, INITIAL_Z); // where operators leave it
+    host::bindPins(&endstops);
+
+    bool starved = false;
+    unsigned long starveStart = 0;
+    uint32_t seen = 0;
+    unsigned long next = micros();
+    while (!stop)
+    {
+      arm.loop();
+      unsigned long now = micros();
+      uint32_t done = arm.getExecuted();
+      for (; seen < done && seen < n; seen++)
+        startUs[seen] = now;
+
+      bool s = done > 0 && done < n && arm.isStarved();
+      if (s && !starved)
+      {
+        starveEvents++;
+        starveStart = now;
+      }
+      else if (!s && starved)
+      {
+        starveUs += now - starveStart;
+      }
+      starved = s;
+      executed.store(done);
+      idle.store(done >= n && arm.isIdle());
+
+      // pace the loop like the target's, without catching up after a stall
+      if (loopUs)
+      {
+        next += loopUs;
+        if ((long)(now - next) > (long)loopUs)
+          next = now;
+        while ((long)(micros() - next) < 0)
+        {
+        }
+      }
+    }
+    tx.flush();
+    host::bindPins(NULL);
+  });
+
+  const double byteUs = 10e6 / baud;
+  std::string outbox; // committed to the wire, not yet delivered
+  std::vector<size_t> endAt; // outbox offsets of line ends not delivered yet
+  double wireUs = micros();
+  int window = RX_BUFFER_SIZE - 1; // an empty buffer, as Bf: reports it
+  int sinceQuery = 0;
+  bool queryPending = false;
+  unsigned long lastQuery = 0;
+  size_t nextLine = 0, delivered = 0;
+  std::string reply;
+  long faults = 0;
+  unsigned long t0 = micros();
+  unsigned long limit = t0 + (unsigned long)(maxS * 1e6);
+  bool finished = false;
+
+  while ((long)(micros() - limit) < 0)
+  {
+    // replies: status lines reopen the window, faults are counted
+    char buf[256];
+    ssize_t got;
+    while ((got = read(master, buf, sizeof(buf))) > 0)
+    {
+      for (ssize_t i = 0; i < got; i++)
+      {
+        if (buf[i] != '\n')
+        {
+          reply += buf[i];
+          continue;
+        }
+        const char *bf = strstr(reply.c_str(), "|Bf:");
+        const char *rx = bf ? strchr(bf + 4, ',') : NULL;
+        if (reply[0] == '<' && rx)
+        {
+          int rxFree = atoi(rx + 1);
+          window = rxFree - sinceQuery;
+          queryPending = false;
+        }
+        else if (reply == "!!\r" || reply == "rs\r")
+        {
+          faults++;
+        }
+        reply.clear();
+      }
+    }
+
+    unsigned long now = micros();
+
+    // commit whole lines while they fit the window
+    while (nextLine < n && (int)(lines[nextLine].len + 2) <= window)
+    {
+      const Line &l = lines[nextLine++];
+      outbox.append(l.text, l.len);
+      outbox += "\r\n";
+      endAt.push_back(outbox.size());
+      window -= l.len + 2;
+      sinceQuery += l.len + 2;
+    }
+    // the next line doesn't fit the window: ask how much room there is now
+    bool shut = nextLine < n && (int)(lines[nextLine].len + 2) > window;
+    if (shut && now - lastQuery >= (queryPending ? QUERY_TIMEOUT_US : QUERY_GAP_US))
+    {
+      outbox += '?';
+      sinceQuery = 0;
+      queryPending = true;
+      lastQuery = now;
+    }
+
+    // the wire delivers at the baud rate
+    if (outbox.empty())
+    {
+      wireUs = std::max(wireUs, (double)now);
+    }
+    else if (wireUs <= now)
+    {
+      size_t k = std::min(outbox.size(), (size_t)((now - wireUs) / byteUs) + 1);
+      ssize_t w = write(master, outbox.data(), k);
+      if (w > 0)
+      {
+        outbox.erase(0, w);
+        wireUs += w * byteUs;
+        size_t e = 0;
+        for (; e < endAt.size() && endAt[e] <= (size_t)w; e++)
+          sentUs[delivered++] = now;
+        endAt.erase(endAt.begin(), endAt.begin() + e);
+        for (size_t j = 0; j < endAt.size(); j++)
+          endAt[j] -= w;
+      }
+    }
+
+    if (delivered == n && idle.load())
+    {
+      finished = true;
+      break;
+    }
+    struct pollfd p = {master, POLLIN, 0};
+    poll(&p, 1, 0);
+  }
+  stop = true;
+  firmware.join();
+  close(master);
+  close(slave);
+
+  size_t done = std::min((size_t)executed.load(), n);
+  std::vector<double> lat;
+  lat.reserve(done);
+  for (size_t i = 0; i < done && i < delivered; i++)
+    lat.push_back((long)(startUs[i] - sentUs[i]) * 1e-3);
+  std::sort(lat.begin(), lat.end());
+  double sum = 0;
+  for (size_t i = 0; i < lat.size(); i++)
+    sum += lat[i];
+
+  r.baud = baud;
+  r.lines = done;
+  r.elapsedS = done ? (startUs[done - 1] - t0) * 1e-6 : 0;
+  r.starveEvents = starveEvents;
+  r.starveS = starveUs * 1e-6;
+  r.latAvgMs = lat.empty() ? 0 : sum / lat.size();
+  r.latP99Ms = lat.empty() ? 0 : lat[(lat.size() - 1) * 99 / 100];
+  r.latMaxMs = lat.empty() ? 0 : lat.back();
+  r.faults = faults;
+  r.finished = finished;
+  return true;
+}
+
+static void usage()
+{
+  fprintf(stderr, "usage: streamBench [-b baud,baud,...] [-l loop_us] [-t max_s] program.gcode\n");
+}
+
+int main(int argc, char **argv)
+{
+  std::vector<unsigned long> bauds;
+  unsigned long loopUs = 100;
+  double maxS = 600;
+
+  int arg = 1;
+  while (arg + 1 < argc && argv[arg][0] == '-')
+  {
+    std::string opt = argv[arg];
+    const char *val = argv[arg + 1];
+    if (opt == "-b")
+    {
+      for (const char *p = val; *p; p += (*p == ',') ? 1 : 0)
+      {
+        char *end;
+        bauds.push_back(strtoul(p, &end, 10));
+        if (end == p || bauds.back() == 0 || (*end != ',' && *end != 0))
+        {
+          usage();
+          return 2;
+        }
+        p = end;
+      }
+    }
+    else if (opt == "-l")
+      loopUs = strtoul(val, NULL, 10);
+    else if (opt == "-t")
+      maxS = atof(val);
+    else
+    {
+      usage();
+      return 2;
+    }
+    arg += 2;
+  }
+  if (arg + 1 != argc || maxS <= 0)
+  {
+    usage();
+    return 2;
+  }
+  if (bauds.empty())
+  {
+    const unsigned long defaults[] = {BAUD, 115200, 250000, MAX_BAUD};
+    bauds.assign(defaults, defaults + 4);
+  }
+
+  int fd = open(argv[arg], O_RDONLY);
+  struct stat st;
+  if (fd < 0 || fstat(fd, &st) < 0)
+  {
+    perror(argv[arg]);
+    return 1;
+  }
+  const char *data = NULL;
+  if (st.st_size > 0)
+  {
+    data = (const char *)mmap(NULL, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    if (data == MAP_FAILED)
+    {
+      perror("mmap");
+      return 1;
+    }
+    madvise((void *)data, st.st_size, MADV_SEQUENTIAL);
+  }
+  std::vector<Line> lines;
+  splitLines(data, st.st_size, lines);
+  if (lines.empty())
+  {
+    fprintf(stderr, "%s: nothing to send\n", argv[arg]);
+    return 1;
+  }
+
+  int failed = 0;
+  printf("baud,lines,elapsed_s,cmds_per_s,starve_events,starve_s,lat_avg_ms,lat_p99_ms,lat_max_ms,faults\n");
+  for (size_t i = 0; i < bauds.size(); i++)
+  {
+    Result r;
+    if (bauds[i] == 0 || !runBaud(lines, bauds[i], loopUs, maxS, r))
+      return 1;
+    printf("%lu,%zu,%.3f,%.1f,%ld,%.3f,%.2f,%.2f,%.2f,%ld\n", r.baud, r.lines, r.elapsedS,
+           r.elapsedS > 0 ? r.lines / r.elapsedS : 0.0, r.starveEvents, r.starveS,
+           r.latAvgMs, r.latP99Ms, r.latMaxMs, r.faults);
+    fflush(stdout);
+    if (!r.finished || r.faults)
+    {
+      fprintf(stderr, "%lu baud: %s\n", r.baud, r.finished ? "faults reported" : "did not finish in time");
+      failed++;
+    }
+  }
+  munmap((void *)data, st.st_size);
+  close(fd);
+  return failed ? 1 : 0;
+}
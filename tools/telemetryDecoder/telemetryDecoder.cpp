@@ -0,0 +1,70 @@
+/*
+ * Decodes the firmware's binary telemetry stream (M154) into CSV.
+ *
+ * Reads raw bytes from a file or stdin, e.g. a capture of the serial port
+ * (stty -F /dev/ttyACM0 250000 raw; cat /dev/ttyACM0 > capture.bin).
+ * Text lines between frames are skipped; frames with a bad checksum are
+ * counted and dropped.
+ *
+ * usage: telemetryDecoder [capture.bin] > telemetry.csv
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include "telemetry.h"
+
+int main(int argc, char **argv)
+{
+  FILE *in = (argc > 1) ? fopen(argv[1], "rb") : stdin;
+  if (in == NULL)
+  {
+    perror(argv[1]);
+    return 1;
+  }
+
+  printf("time_us,higher,lower,rotate,x_mm,y_mm,z_mm,queue,loop_max_us,loop_avg_us\n");
+
+  long frames = 0, bad = 0;
+  uint8_t buf[4096];
+  size_t len = 0;
+  size_t n;
+  while ((n = fread(buf + len, 1, sizeof(buf) - len, in)) > 0)
+  {
+    len += n;
+    size_t pos = 0;
+    while (len - pos >= sizeof(TelemetryFrame))
+    {
+      if (buf[pos] != TELEMETRY_SYNC0 || buf[pos + 1] != TELEMETRY_SYNC1)
+      {
+        pos++;
+        continue;
+      }
+
+      TelemetryFrame frame;
+      memcpy(&frame, buf + pos, sizeof(frame));
+      const uint8_t *payload = (const uint8_t *)&frame.timeUs;
+      uint8_t sum = 0;
+      for (size_t i = 0; i < TELEMETRY_PAYLOAD; i++)
+        sum ^= payload[i];
+      if (frame.length != TELEMETRY_PAYLOAD || sum != frame.checksum)
+      {
+        // not a frame after all, keep searching past this sync byte
+        bad++;
+        pos++;
+        continue;
+      }
+
+      printf("%lu,%ld,%ld,%ld,%.3f,%.3f,%.3f,%u,%u,%u\n",
+             (unsigned long)frame.timeUs, (long)frame.higher, (long)frame.lower, (long)frame.rotate,
+             frame.xmm, frame.ymm, frame.zmm, frame.queue, frame.loopMaxUs, frame.loopAvgUs);
+      frames++;
+      pos += sizeof(frame);
+    }
+    memmove(buf, buf + pos, len - pos);
+    len -= pos;
+    fflush(stdout);
+  }
+
+  fprintf(stderr, "%ld frames, %ld rejected\n", frames, bad);
+  return 0;
+}